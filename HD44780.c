@@ -10,17 +10,184 @@
 
 /* ####################### Includes ############################# */
 #include "HD44780.h"
+#if (HD44780_USE_RTOS == 1)
+#include "HD44780_RTOS.h"
+#endif
+
+/* ###################### Private macros ######################### */
+#if (HD44780_USE_STATS == 1)
+#define HD44780_STAT_ADD(Handle, Field, Amount)     ((Handle)->Stats.Field += (uint32_t)(Amount))
+#else
+#define HD44780_STAT_ADD(Handle, Field, Amount)     ((void)0)
+#endif
+
+#if (HD44780_TRACE_DEPTH > 0)
+#define HD44780_TRACE(Handle, Type, Value)          HD44780_Trace_Record((Handle), (Type), (Value))
+#else
+#define HD44780_TRACE(Handle, Type, Value)          ((void)0)
+#endif
 
 /* ################### Private variables ######################## */
-static uint8_t AddressCounter; /* Stores address location of LCD cursor. See HD44780 pg.9*/
+#if (HD44780_DELAY_BACKEND == HD44780_DELAY_TIM)
+extern TIM_HandleTypeDef HD44780_DELAY_TIM_HANDLE; /* Defined by CubeMX in main.c */
+#endif
+#if (HD44780_USE_ASYNC == 1)
+static HD44780_HandleTypeDef *Async_Handles[HD44780_MAX_DISPLAYS]; /* Looked up from the HAL I2C callbacks */
+#endif
+#if (HD44780_USE_ARENA == 1)
+static char HD44780_Arena[HD44780_ARENA_SIZE];                      /* Text and frames of every handle */
+static uint16_t HD44780_Arena_Used;
+static HD44780_HandleTypeDef *Arena_Owner[HD44780_MAX_DISPLAYS];    /* Handles holding storage, re-init reuses it */
+static char *Arena_Storage[HD44780_MAX_DISPLAYS];
+static uint16_t Arena_Length[HD44780_MAX_DISPLAYS];
+#endif
+
+/* ############ Precomputed PCF8574 streams, kept in flash ############ */
+static const uint8_t HD44780_Command_Codes[] = {
+	[CLEAR_DISPLAY]  = 0x01,
+	[RETURN_HOME]    = 0x02
+}; /* Other commands change the shadowed display control register or the backlight */
+
+static const uint8_t HD44780_Command_Streams[][HD44780_COMMAND_FRAME_LEN] = {
+	[CLEAR_DISPLAY]  = { HD44780_NIBBLE_STREAM(0x01, HD44780_BACKLIGHT) },
+	[RETURN_HOME]    = { HD44780_NIBBLE_STREAM(0x02, HD44780_BACKLIGHT) }
+};
+
+typedef struct {
+	const uint8_t           *Bytes;
+	uint8_t                 Length;
+	uint16_t                Wait_us;    /* After the step, 0 = execution time of its last instruction */
+	bool                    Busy_Flag;  /* Busy flag can be read after this step (4-bit mode) */
+} HD44780_Init_StepTypeDef;
+
+static const uint8_t HD44780_Init_8Bit[] = { (0x30 | HD44780_EN), 0x30 }; /* Function set 8-bit, one nibble per instruction */
+static const uint8_t HD44780_Init_4Bit[] = { (0x20 | HD44780_EN), 0x20 }; /* Function set 4-bit, still a single nibble */
+
+/* Function set (1 or 2 lines), display off and clear display in one transfer. The next
+   instruction latches two port bytes (Leadin_us of the transport) after the previous one */
+static const uint8_t HD44780_Init_Setup_1Line[] = {
+	HD44780_NIBBLE_STREAM(HD44780_FUNCTION_SET, HD44780_BACKLIGHT),
+	HD44780_NIBBLE_STREAM(0x08, HD44780_BACKLIGHT),
+	HD44780_NIBBLE_STREAM(0x01, HD44780_BACKLIGHT)
+};
+static const uint8_t HD44780_Init_Setup_2Line[] = {
+	HD44780_NIBBLE_STREAM((HD44780_FUNCTION_SET | (1<<3)), HD44780_BACKLIGHT), /* Also used by 4 row displays */
+	HD44780_NIBBLE_STREAM(0x08, HD44780_BACKLIGHT),
+	HD44780_NIBBLE_STREAM(0x01, HD44780_BACKLIGHT)
+};
+static const uint8_t HD44780_Init_Start[] = {
+	HD44780_NIBBLE_STREAM(0x06, HD44780_BACKLIGHT), /* Auto-increment, no display shift */
+	HD44780_NIBBLE_STREAM(0x0E, HD44780_BACKLIGHT)  /* Turn display and cursor on */
+};
+
+/* HD44780 pg. 46, Figure 24. Entry 4 is replaced by HD44780_Init_Setup_1Line for 1 row displays */
+static const HD44780_Init_StepTypeDef HD44780_Init_Sequence[] = {
+	{ HD44780_Init_8Bit,        sizeof(HD44780_Init_8Bit),        HD44780_T_INIT_1_US, false },
+	{ HD44780_Init_8Bit,        sizeof(HD44780_Init_8Bit),        HD44780_T_INIT_2_US, false },
+	{ HD44780_Init_8Bit,        sizeof(HD44780_Init_8Bit),        HD44780_T_EXEC_US,   false },
+	{ HD44780_Init_4Bit,        sizeof(HD44780_Init_4Bit),        HD44780_T_EXEC_US,   false },
+	{ HD44780_Init_Setup_2Line, sizeof(HD44780_Init_Setup_2Line), 0,                   true },
+	{ HD44780_Init_Start,       sizeof(HD44780_Init_Start),       0,                   true }
+};
+#define HD44780_INIT_STEPS      (sizeof(HD44780_Init_Sequence) / sizeof(HD44780_Init_Sequence[0]))
+#define HD44780_INIT_SETUP_STEP 4
 
 /* ################### Private Function Prototypes ############### */
 static void HD44780_Check_Status(HD44780_HandleTypeDef *Display_Handle);
+static bool HD44780_Sample_Busy(HD44780_HandleTypeDef *Display_Handle, uint32_t Start_us, uint32_t *Sample_us);
+static uint32_t HD44780_Calibrate_Trial(HD44780_HandleTypeDef *Display_Handle, uint32_t Delay_us, uint32_t *Busy_us, uint32_t *Ready_us);
+static bool HD44780_Read_Data(HD44780_HandleTypeDef *Display_Handle, uint8_t Address, char *Buffer, uint8_t Length);
 static void HD44780_Send_Command(HD44780_HandleTypeDef *Display_Handle, uint8_t Command, bool CheckBusyFlag);
+static void HD44780_Send_Stream(HD44780_HandleTypeDef *Display_Handle, uint8_t Command, const uint8_t *Stream, bool CheckBusyFlag);
+static void HD44780_Send_Fixed(HD44780_HandleTypeDef *Display_Handle, HD44780_User_Command_List UserCommand);
 static void HD44780_Send_Data(HD44780_HandleTypeDef *Display_Handle, uint8_t Command, bool CheckBusyFlag);
 static void HD44780_Error_Handler(HD44780_HandleTypeDef *Display_Handle);
+static uint8_t HD44780_Encode_Nibbles(uint8_t *Frame, uint8_t Value, uint8_t ControlBits);
+static bool HD44780_Write_Burst(HD44780_HandleTypeDef *Display_Handle, const uint8_t *Frame, uint16_t Length);
+static bool HD44780_Read_Port(HD44780_HandleTypeDef *Display_Handle, uint8_t *PortByte);
+static void HD44780_Fault(HD44780_HandleTypeDef *Display_Handle, HD44780_State State);
+static void HD44780_Bus_Recovery(HD44780_HandleTypeDef *Display_Handle);
+static bool HD44780_I2C_Probe(HD44780_HandleTypeDef *Display_Handle, uint32_t Trials, uint32_t Timeout_ms);
+static HAL_StatusTypeDef HD44780_I2C_Write(HD44780_HandleTypeDef *Display_Handle, const uint8_t *PortBytes, uint16_t Length);
+static HAL_StatusTypeDef HD44780_I2C_Read(HD44780_HandleTypeDef *Display_Handle, uint8_t *PortByte);
+static bool HD44780_Always(HD44780_HandleTypeDef *Display_Handle);
+static bool HD44780_GPIO_Probe(HD44780_HandleTypeDef *Display_Handle, uint32_t Trials, uint32_t Timeout_ms);
+static HAL_StatusTypeDef HD44780_GPIO_Write(HD44780_HandleTypeDef *Display_Handle, const uint8_t *PortBytes, uint16_t Length);
+static HAL_StatusTypeDef HD44780_GPIO_Read(HD44780_HandleTypeDef *Display_Handle, uint8_t *PortByte);
+static bool HD44780_GPIO_Can_Read(HD44780_HandleTypeDef *Display_Handle);
+#if defined(HAL_SPI_MODULE_ENABLED)
+static HAL_StatusTypeDef HD44780_HC595_Write(HD44780_HandleTypeDef *Display_Handle, const uint8_t *PortBytes, uint16_t Length);
+static HAL_StatusTypeDef HD44780_HC595_Read(HD44780_HandleTypeDef *Display_Handle, uint8_t *PortByte);
+static bool HD44780_Never(HD44780_HandleTypeDef *Display_Handle);
+#endif
+static void HD44780_Software_Reset(HD44780_HandleTypeDef *Display_Handle);
+#if (HD44780_WARM_RESTART == 1)
+static bool HD44780_Probe_Warm(HD44780_HandleTypeDef *Display_Handle);
+static void HD44780_Warm_Restart(HD44780_HandleTypeDef *Display_Handle);
+#endif
+static void HD44780_Restore_Display(HD44780_HandleTypeDef *Display_Handle);
+static void HD44780_Check_Health(HD44780_HandleTypeDef *Display_Handle);
+#if (HD44780_TRACE_DEPTH > 0)
+static void HD44780_Trace_Record(HD44780_HandleTypeDef *Display_Handle, HD44780_Trace_Type Type, uint8_t Value);
+#endif
+static void HD44780_Delay_Init(void);
+static void HD44780_Delay_us(uint32_t Microseconds);
+static void HD44780_Spin_us(uint32_t Microseconds);
+static void HD44780_Delay_ms(uint32_t Milliseconds);
+static void HD44780_Wait_us(HD44780_HandleTypeDef *Display_Handle, uint32_t Microseconds);
+static uint32_t HD44780_Sleep_us(uint32_t Microseconds);
+static uint32_t HD44780_Sleep_Clock_us(void);
+static void HD44780_Wait_Execution(HD44780_HandleTypeDef *Display_Handle, uint32_t ExecutionTime_us, bool CheckBusyFlag);
+static uint32_t HD44780_Get_Execution_Time(HD44780_HandleTypeDef *Display_Handle, uint8_t Command);
+static void HD44780_Write_Port(HD44780_HandleTypeDef *Display_Handle, uint8_t PortByte);
+static void HD44780_Write_Register(HD44780_HandleTypeDef *Display_Handle, uint8_t *Shadow, uint8_t Value);
+static void HD44780_Set_Backlight(HD44780_HandleTypeDef *Display_Handle, uint8_t Backlight);
+#if (HD44780_USE_ASYNC == 1)
+static bool HD44780_Time_Elapsed(uint32_t Timestamp, uint32_t Microseconds);
+static void HD44780_Queue_Frame(HD44780_HandleTypeDef *Display_Handle, const uint8_t *Frame, uint8_t Length, uint32_t Delay_us, bool Mergeable);
+static void HD44780_Queue_Start(HD44780_HandleTypeDef *Display_Handle);
+static void HD44780_Register_Handle(HD44780_HandleTypeDef *Display_Handle);
+static void HD44780_Schedule_Bus(I2C_HandleTypeDef *hi2c, uint8_t First);
+static void HD44780_Service_Queue(HD44780_HandleTypeDef *Display_Handle);
+static void HD44780_Wait_Slot(HD44780_HandleTypeDef *Display_Handle);
+#endif
 static void HD44780_Get_Cursor_Position(HD44780_HandleTypeDef *Display_Handle);
+static uint8_t HD44780_Get_Address(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column);
+static bool HD44780_Uses_Busy_Flag(HD44780_HandleTypeDef *Display_Handle);
 static void Clear_Text_Buffer(HD44780_HandleTypeDef *Display_Handle);
+#if (HD44780_USE_SHADOW == 1)
+static bool HD44780_Cell_Matches(char Shown, char Wanted);
+#endif
+static uint8_t HD44780_Next_Address(HD44780_HandleTypeDef *Display_Handle, uint8_t Address);
+#if (HD44780_USE_ARENA == 1)
+static bool HD44780_Arena_Take(HD44780_HandleTypeDef *Display_Handle, uint16_t Cells);
+#endif
+#if (HD44780_FRAME_BUFFERS > 0)
+static void HD44780_Add_Cost(HD44780_HandleTypeDef *Display_Handle, HD44780_CostTypeDef *Cost, uint8_t PortBytes, uint32_t ExecutionTime_us);
+static void HD44780_Add_Data_Cost(HD44780_HandleTypeDef *Display_Handle, HD44780_CostTypeDef *Cost, uint8_t RunIndex);
+static bool HD44780_Bridge_Gap(HD44780_HandleTypeDef *Display_Handle, uint8_t Gap, uint8_t RunIndex);
+static void HD44780_Flush_Rows(HD44780_HandleTypeDef *Display_Handle, const char *Frame, uint8_t FirstRow, uint8_t LastRow, bool Cleared, HD44780_CostTypeDef *Plan);
+static void HD44780_Plan_Flush(HD44780_HandleTypeDef *Display_Handle, const char *Frame, HD44780_CostTypeDef *Cost);
+static bool HD44780_Take_Frame(HD44780_HandleTypeDef *Display_Handle);
+static void HD44780_Send_Frame(HD44780_HandleTypeDef *Display_Handle);
+static void HD44780_Frame_Set_All(HD44780_HandleTypeDef *Display_Handle, uint16_t Index, char Character);
+static uint16_t HD44780_Scroll_Period_Length(HD44780_HandleTypeDef *Display_Handle, uint8_t row);
+static void HD44780_Scroll_Render(HD44780_HandleTypeDef *Display_Handle, uint8_t row);
+static void HD44780_Scroll_Select(HD44780_HandleTypeDef *Display_Handle);
+static void HD44780_Scroll_Tick(HD44780_HandleTypeDef *Display_Handle);
+static void HD44780_Scroll_Home(HD44780_HandleTypeDef *Display_Handle, bool Cleared);
+static void HD44780_Canvas_Load(HD44780_HandleTypeDef *Display_Handle, HD44780_CanvasTypeDef *Canvas);
+static void HD44780_Canvas_Release(HD44780_HandleTypeDef *Display_Handle);
+static void HD44780_Canvas_Shift(HD44780_HandleTypeDef *Display_Handle, uint16_t column);
+static char HD44780_Canvas_Cell(const HD44780_CanvasTypeDef *Canvas, uint16_t row, uint16_t column);
+static uint8_t HD44780_Format_Digits(char *Digits, uint32_t Value, uint8_t Base, uint8_t Decimals, char Alpha);
+static void HD44780_Frame_Number(HD44780_HandleTypeDef *Display_Handle, uint16_t *Index, uint16_t End, const char *Digits, uint8_t Length, bool Negative, uint8_t Width, char Pad, bool Left);
+#endif
+static bool HD44780_Glyph_On_Screen(HD44780_HandleTypeDef *Display_Handle, uint8_t Slot);
+static void HD44780_Glyph_Upload(HD44780_HandleTypeDef *Display_Handle);
+#if (HD44780_POST_DEPTH > 0)
+static void HD44780_Post_Drain(HD44780_HandleTypeDef *Display_Handle);
+#endif
 
 /* ####################### Private Functions ##################### */
 /**
@@ -31,469 +198,3662 @@ static void Clear_Text_Buffer(HD44780_HandleTypeDef *Display_Handle);
   */
 static void HD44780_Check_Status(HD44780_HandleTypeDef *Display_Handle)
 {
-	uint8_t ReadCommand;
-	uint8_t ReadBuffer;
+	uint8_t ReadFrame[2];
+	uint8_t ReadBuffer = 0;
 	uint8_t Data_7_4 = 0;
 	uint8_t Data_3_0 = 0;
 	uint8_t Data;
-
-	/* Check busy flag instruction */
-	ReadCommand = (0xF0 | HD44780_BACKLIGHT | HD44780_RW); /* PCF8574 pg.9: data bits must be set HIGH before read */
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &ReadCommand, 1, 200);
-	HAL_Delay(1);
-
-	/* Read first 4 bits of data (MSB first) */
-	ReadCommand |= (HD44780_EN);
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &ReadCommand, 1, 200);
-	HAL_Delay(1);
-	HAL_I2C_Master_Receive(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &ReadBuffer, 1, 200);
+	const uint8_t ReadCommand = (0xF0 | Display_Handle->Backlight | HD44780_RW); /* PCF8574 pg.9: data bits must be set HIGH before read */
+
+	/* Check busy flag instruction, then raise EN to read first 4 bits of data (MSB first) */
+	ReadFrame[0] = ReadCommand;
+	ReadFrame[1] = (ReadCommand | HD44780_EN);
+	HD44780_Write_Burst(Display_Handle, ReadFrame, 2);
+	HD44780_Delay_us(HD44780_T_DATA_DELAY_US);
+	HD44780_Read_Port(Display_Handle, &ReadBuffer);
 	Data_7_4 = (ReadBuffer & 0xF0); /*only care about first 4 bits*/
-	ReadCommand &= ~(HD44780_EN);
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &ReadCommand, 1, 200);
-	HAL_Delay(1);
-
-	/* Read last 4 bits of data */
-	ReadCommand |= (HD44780_EN);
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &ReadCommand, 1, 200);
-	HAL_Delay(1);
-	HAL_I2C_Master_Receive(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &ReadBuffer, 1, 200);
+
+	/* Drop EN and raise it again to read last 4 bits of data */
+	ReadFrame[0] = ReadCommand;
+	ReadFrame[1] = (ReadCommand | HD44780_EN);
+	HD44780_Write_Burst(Display_Handle, ReadFrame, 2);
+	HD44780_Delay_us(HD44780_T_DATA_DELAY_US);
+	HD44780_Read_Port(Display_Handle, &ReadBuffer);
 	Data_3_0 = ((ReadBuffer >> 4) & 0x0F);
-	ReadCommand &= ~(HD44780_EN);
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &ReadCommand, 1, 200);
-	HAL_Delay(1);
+	HD44780_Write_Burst(Display_Handle, ReadFrame, 1); /* EN LOW */
+
+	if (Display_Handle->Needs_Reinit) {
+		return;
+	} /* Transfer failed, State already says why */
 
 	Data = (Data_7_4 | Data_3_0);
+	HD44780_STAT_ADD(Display_Handle, Busy_Polls, 1);
+	HD44780_TRACE(Display_Handle, HD44780_TRACE_STATUS, Data);
 	if ((Data) & (1<<7)) { /* Busy flag set */
 		Display_Handle->State = HD44780_BUSY;
 	}
 
 	else {
-		AddressCounter = (Data & ~(1<<7)); /* Update AddressCounter with new data */
+		Display_Handle->AddressCounter = (Data & ~(1<<7)); /* Hardware value replaces the software model */
 		Display_Handle->State = HD44780_READY;
 	}
 }
 
+/**
+  * @brief 	Reads the busy flag once like HD44780_Check_Status() and notes when it was sampled. The
+  * 		PCF8574 latches its port during the receive, so the time is taken once that returns and
+  * 		is late by at most one byte, which only ever makes the module look slower.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	HD44780_Sleep_Clock_us() the sample is measured from.
+  * @param 	Receives the sample time, microseconds after Start_us.
+  * @retval True if the busy flag was set or the read failed (Display_Handle->Needs_Reinit).
+  */
+static bool HD44780_Sample_Busy(HD44780_HandleTypeDef *Display_Handle, uint32_t Start_us, uint32_t *Sample_us)
+{
+	const uint8_t ReadCommand = (0xF0 | Display_Handle->Backlight | HD44780_RW);
+	const uint8_t ReadFrame[2] = { ReadCommand, (ReadCommand | HD44780_EN) };
+	uint8_t Upper = 0;
+	uint8_t Lower = 0;
+
+	HD44780_Write_Burst(Display_Handle, ReadFrame, 2);
+	HD44780_Delay_us(HD44780_T_DATA_DELAY_US);
+	HD44780_Read_Port(Display_Handle, &Upper);
+	*Sample_us = (HD44780_Sleep_Clock_us() - Start_us);
+	HD44780_Write_Burst(Display_Handle, ReadFrame, 2);
+	HD44780_Delay_us(HD44780_T_DATA_DELAY_US);
+	HD44780_Read_Port(Display_Handle, &Lower); /* Completes the 4-bit read */
+	HD44780_Write_Burst(Display_Handle, ReadFrame, 1); /* EN LOW */
+
+	HD44780_STAT_ADD(Display_Handle, Busy_Polls, 1);
+	HD44780_TRACE(Display_Handle, HD44780_TRACE_STATUS, (uint8_t)((Upper & 0xF0) | ((Lower >> 4) & 0x0F)));
+
+	return Display_Handle->Needs_Reinit || (Upper & 0x80);
+}
+
+/**
+  * @brief 	Times one return home (1.52ms in the datasheet, pg. 24 Table 6). Waits Delay_us after the
+  * 		instruction is latched, then samples the busy flag until it clears. Every sample narrows
+  * 		the window the real execution time lies in.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Time to let pass before the first sample, so it lands inside the window.
+  * @param 	Latest sample that found the HD44780 busy, raised by this trial.
+  * @param 	Earliest sample that found it ready, lowered by this trial.
+  * @retval Time of the first sample, microseconds after the instruction.
+  */
+static uint32_t HD44780_Calibrate_Trial(HD44780_HandleTypeDef *Display_Handle, uint32_t Delay_us, uint32_t *Busy_us, uint32_t *Ready_us)
+{
+	uint8_t Frame[HD44780_COMMAND_FRAME_LEN];
+	uint32_t Sample_us = 0;
+	uint32_t First_us = 0;
+
+	HD44780_Encode_Nibbles(Frame, 0x02, Display_Handle->Backlight);
+	HD44780_TRACE(Display_Handle, HD44780_TRACE_COMMAND, 0x02);
+	if (!HD44780_Write_Burst(Display_Handle, Frame, HD44780_COMMAND_FRAME_LEN)) {
+		return 0;
+	}
+	const uint32_t Start_us = HD44780_Sleep_Clock_us(); /* Lower nibble latched by the last port byte */
+	Display_Handle->AddressCounter = 0;
+	HD44780_Spin_us(Delay_us); /* Not rounded to kernel ticks with HD44780_USE_RTOS */
+
+	for (bool First = true; HD44780_Sample_Busy(Display_Handle, Start_us, &Sample_us); First = false) {
+		if (First) {
+			First_us = Sample_us;
+		}
+
+		if (Display_Handle->Needs_Reinit || (Sample_us > (HD44780_BUSY_TIMEOUT_MS * 1000U))) {
+			return First_us;
+		}
+
+		if (Sample_us > *Busy_us) {
+			*Busy_us = Sample_us;
+		}
+	}
+
+	if (Sample_us < *Ready_us) {
+		*Ready_us = Sample_us;
+	}
+
+	return (First_us == 0) ? Sample_us : First_us;
+}
+
+/**
+  * @brief 	Reads consecutive DDRAM cells. Set DDRAM address selects the first one, after that every
+  * 		read moves the address counter on by itself (HD44780 pg. 9, pg. 24). Each nibble costs one
+  * 		2 byte write (EN LOW ends the previous nibble, EN HIGH presents the next) and one 1 byte
+  * 		receive. The PCF8574 only changes its port on a write, so the nibbles can't share a receive.
+  * 		A 1 byte write drops EN after the lower nibble: the read executes from that falling edge,
+  * 		so the execution time is waited with EN LOW. Leaves the address counter after the last cell.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	DDRAM address of the first cell.
+  * @param 	Receives Length characters, not terminated.
+  * @param 	Number of cells.
+  * @retval False if a transfer failed, Buffer is then incomplete.
+  */
+static bool HD44780_Read_Data(HD44780_HandleTypeDef *Display_Handle, uint8_t Address, char *Buffer, uint8_t Length)
+{
+	const uint8_t ReadCommand = (0xF0 | Display_Handle->Backlight | HD44780_RW | HD44780_RS); /* PCF8574 pg.9: data bits HIGH before read */
+	const uint8_t ReadFrame[2] = { ReadCommand, (ReadCommand | HD44780_EN) };
+	uint8_t PortByte = 0;
+
+	HD44780_Send_Command(Display_Handle, (0x80 | Address), true);
+
+	for (uint8_t i = 0; i < Length; i++) {
+		uint8_t Data = 0;
+		for (uint8_t Nibble = 0; Nibble < 2; Nibble++) {
+			HD44780_Write_Burst(Display_Handle, ReadFrame, 2);
+			HD44780_Delay_us(HD44780_T_DATA_DELAY_US);
+			HD44780_Read_Port(Display_Handle, &PortByte);
+			Data = (Nibble == 0) ? (PortByte & 0xF0) : (uint8_t)(Data | ((PortByte >> 4) & 0x0F));
+		} /* Upper nibble first */
+
+		HD44780_Write_Burst(Display_Handle, ReadFrame, 1); /* EN LOW, ends the read */
+
+		HD44780_TRACE(Display_Handle, HD44780_TRACE_READ, Data);
+		Buffer[i] = (char)Data;
+		Display_Handle->AddressCounter = HD44780_Next_Address(Display_Handle, Display_Handle->AddressCounter);
+		HD44780_Wait_Execution(Display_Handle, Display_Handle->Exec_Time_us, false); /* Next cell is fetched into the data register */
+	}
+
+	return !Display_Handle->Needs_Reinit;
+}
+
 /**
   * @brief 	Writes control command to HD44780 (RS and R/W bits = LOW).
   * 		See HD44780 pg. 24 and pg. 58, Figure 25.
   * @param 	Pointer to HD44780_HandleTypeDef struct.
   * @param 	Hex command to be sent.
-  * @param 	CheckBusyFlag.
+  * @param 	CheckBusyFlag. False always waits out the execution time instead.
   */
 static void HD44780_Send_Command(HD44780_HandleTypeDef *Display_Handle, uint8_t Command, bool CheckBusyFlag)
 {
+	uint8_t Frame[HD44780_COMMAND_FRAME_LEN];
+	HD44780_Encode_Nibbles(Frame, Command, Display_Handle->Backlight);
+	HD44780_Send_Stream(Display_Handle, Command, Frame, CheckBusyFlag);
+}
+
+/**
+  * @brief 	Sends an instruction that is already expanded into HD44780_COMMAND_FRAME_LEN port bytes,
+  * 		e.g. one of HD44780_Command_Streams[] straight from flash. See HD44780_Send_Command().
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Instruction encoded in Stream, for the address counter model and execution time.
+  * @param 	Port bytes of the instruction.
+  * @param 	CheckBusyFlag. False always waits out the execution time instead.
+  */
+static void HD44780_Send_Stream(HD44780_HandleTypeDef *Display_Handle, uint8_t Command, const uint8_t *Stream, bool CheckBusyFlag)
+{
+	HD44780_TRACE(Display_Handle, HD44780_TRACE_COMMAND, Command);
+
+	/* Track the address counter in software, the driver issues every instruction that moves it */
+	if (Command & 0x80) {
+		Display_Handle->AddressCounter = (Command & 0x7F);
+	} /* Set DDRAM address */
+
+	else if ((Command == 0x01) | ((Command & 0xFE) == 0x02)) {
+		Display_Handle->AddressCounter = 0;
+	} /* Clear display or return home */
+
+	if (Display_Handle->Needs_Reinit) {
+		return;
+	} /* Display lost, the model keeps tracking what HD44780_Check_Health() rebuilds */
 	Display_Handle->State = HD44780_BUSY;
 
-	uint8_t WriteCommand = 0;
-	const uint8_t Command_7_4 = (0xF0 & Command);
-	const uint8_t Command_3_0 = (0xF0 & (Command<<4));
-
-	/* Write first 4 bits of data (MSB first) */
-	WriteCommand |= Command_7_4 | HD44780_BACKLIGHT | HD44780_EN;
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-	HAL_Delay(1);
-	WriteCommand &= ~(HD44780_EN);
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-	HAL_Delay(1);
-
-	/* Write last 4 bits of data */
-	WriteCommand &= 0x0F;
-	WriteCommand |= (Command_3_0 | HD44780_BACKLIGHT | HD44780_EN);
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-	HAL_Delay(1);
-	WriteCommand &= ~(HD44780_EN);
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-	HAL_Delay(1);
-
-	/* Exit once HD44780 is finished writing an instruction (busy flag isn't set) */
-	if (CheckBusyFlag) {
-		for (int i = 0; i < 20; i++) {
-			HD44780_Check_Status(Display_Handle);
-			if (Display_Handle->State == HD44780_READY) {
-				return;
-			}
-		}
+#if (HD44780_USE_ASYNC == 1)
+	if (Display_Handle->Async_Enabled) {
+		HD44780_Queue_Frame(Display_Handle, Stream, HD44780_COMMAND_FRAME_LEN, HD44780_Get_Execution_Time(Display_Handle, Command), false);
+		return;
+	} /* Busy flag can't be read while the queue owns the bus */
+#endif
 
-		/* >100ms has passed at this point at this point. Throw timeout error */
-		Display_Handle->State = HD44780_TIMEOUT;
-		HD44780_Error_Handler(Display_Handle);
+	/* Both nibbles (EN HIGH then LOW, MSB first) go out in a single transmit */
+	if (!HD44780_Write_Burst(Display_Handle, Stream, HD44780_COMMAND_FRAME_LEN)) {
+		return;
 	}
+#if (HD44780_USE_STATS == 1)
+	const uint32_t WaitStart = HD44780_Get_Timestamp();
+	HD44780_Wait_Execution(Display_Handle, HD44780_Get_Execution_Time(Display_Handle, Command), CheckBusyFlag);
+	HD44780_STAT_ADD(Display_Handle, Blocked_Time, (HD44780_Get_Timestamp() - WaitStart));
+#else
+	HD44780_Wait_Execution(Display_Handle, HD44780_Get_Execution_Time(Display_Handle, Command), CheckBusyFlag);
+#endif
+}
 
-	else {
-		Display_Handle->State = HD44780_READY;
-	} /* Not checking busy flag */
+/**
+  * @brief 	Sends one of the fixed HD44780_Transmit_Command() instructions from HD44780_Command_Streams[].
+  * 		The streams keep the backlight on, with the backlight off the instruction is encoded instead.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	UserCommand, must have an entry in HD44780_Command_Codes[].
+  */
+static void HD44780_Send_Fixed(HD44780_HandleTypeDef *Display_Handle, HD44780_User_Command_List UserCommand)
+{
+	if (Display_Handle->Backlight != HD44780_BACKLIGHT) {
+		HD44780_Send_Command(Display_Handle, HD44780_Command_Codes[UserCommand], true);
+		return;
+	}
+
+	HD44780_Send_Stream(Display_Handle, HD44780_Command_Codes[UserCommand], HD44780_Command_Streams[UserCommand], true);
 }
 
 /**
   * @brief 	Writes data to HD44780 DDRAM. Same process as HD44780_Send_Command
   * 		except (RS = HIGH and R/W = LOW). See HD44780 pg. 17, Table 4 and pg. 58, Figure 25.
+  * 		The RS setup byte is left out when the port already holds RS HIGH from the previous data write.
   * @param 	Pointer to HD44780_HandleTypeDef struct.
   * @param 	Hex data to be sent.
+  * @param 	CheckBusyFlag. False always waits out the execution time instead.
   */
 static void HD44780_Send_Data(HD44780_HandleTypeDef *Display_Handle, uint8_t Command, bool CheckBusyFlag)
 {
+	const uint8_t ControlBits = (Display_Handle->Backlight | HD44780_RS);
+	uint8_t Frame[HD44780_DATA_FRAME_LEN];
+	Frame[0] = ControlBits; /* RS line must settle before pulling EN HIGH */
+	const uint8_t Length = 1 + HD44780_Encode_Nibbles(&Frame[1], Command, ControlBits);
+	HD44780_TRACE(Display_Handle, HD44780_TRACE_DATA, Command);
+
+	Display_Handle->AddressCounter = HD44780_Next_Address(Display_Handle, Display_Handle->AddressCounter); /* Auto-increment, see HD44780_Send_Command */
+
+	if (Display_Handle->Needs_Reinit) {
+		return;
+	}
 	Display_Handle->State = HD44780_BUSY;
 
-	uint8_t WriteCommand = 0;
-	const uint8_t Command_7_4 = (0xF0 & Command);
-	const uint8_t Command_3_0 = (0xF0 & (Command<<4));
-
-	/* Write first 4 bits of data (MSB first) */
-	WriteCommand |= HD44780_BACKLIGHT | HD44780_RS;
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-	HAL_Delay(1); /* RS line must settle before pulling EN HIGH */
-	WriteCommand |= Command_7_4 | HD44780_BACKLIGHT | HD44780_EN | HD44780_RS;
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-	HAL_Delay(1);
-	WriteCommand &= ~(HD44780_EN);
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-	HAL_Delay(1);
-
-	/* Write last 4 bits of data */
-	WriteCommand &= 0x0F;
-	WriteCommand |= (Command_3_0 | HD44780_BACKLIGHT | HD44780_EN | HD44780_RS);
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-	HAL_Delay(1);
-	WriteCommand &= ~(HD44780_EN);
-	HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-	HAL_Delay(1);
-
-
-	/* Exit once HD44780 is finished writing an instruction (busy flag isn't set) */
-	if (CheckBusyFlag) {
-		for (uint8_t i = 0; i < 20; i++) {
+#if (HD44780_USE_ASYNC == 1)
+	if (Display_Handle->Async_Enabled) {
+		HD44780_Queue_Frame(Display_Handle, Frame, Length, Display_Handle->Exec_Time_us, true);
+		return;
+	}
+#endif
+
+	const uint8_t Setup = ((Display_Handle->Port_Byte & 0x0F) == ControlBits) ? 1 : 0; /* RS still HIGH from the last data write */
+	if (!HD44780_Write_Burst(Display_Handle, &Frame[Setup], (Length - Setup))) {
+		return;
+	}
+#if (HD44780_USE_STATS == 1)
+	const uint32_t WaitStart = HD44780_Get_Timestamp();
+	HD44780_Wait_Execution(Display_Handle, Display_Handle->Exec_Time_us, CheckBusyFlag);
+	HD44780_STAT_ADD(Display_Handle, Blocked_Time, (HD44780_Get_Timestamp() - WaitStart));
+#else
+	HD44780_Wait_Execution(Display_Handle, Display_Handle->Exec_Time_us, CheckBusyFlag);
+#endif
+}
+
+/**
+  * @brief 	Waits until the HD44780 has finished the instruction that was just written, according to
+  * 		Display_Handle->Exec_Mode. Busy flag polling costs 6 bus transactions per check, timed
+  * 		execution waits out the worst case execution time instead and needs no read path at all.
+  * 		The wait is skipped when the START/address byte of the next transfer already covers it.
+  * 		In HD44780_WAIT_SLEEP long instructions (clear display) are slept out before the busy flag is read.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Worst case execution time of the instruction.
+  * @param 	CheckBusyFlag. False always uses timed execution.
+  */
+static void HD44780_Wait_Execution(HD44780_HandleTypeDef *Display_Handle, uint32_t ExecutionTime_us, bool CheckBusyFlag)
+{
+	if (CheckBusyFlag && (Display_Handle->Exec_Mode != HD44780_EXEC_TIMED)) {
+		const bool SleepFirst = ((Display_Handle->Wait_Mode == HD44780_WAIT_SLEEP) && (ExecutionTime_us > HD44780_SLEEP_WAKE_US));
+		if ((Display_Handle->Exec_Mode == HD44780_EXEC_TIMED_VERIFY) || SleepFirst) {
+			HD44780_Wait_us(Display_Handle, ExecutionTime_us);
 			HD44780_Check_Status(Display_Handle);
-			if (Display_Handle->State == HD44780_READY) {
+			if (Display_Handle->State != HD44780_BUSY) {
 				return;
 			}
-		}
-		/* >100ms has passed at this point at this point. Throw timeout error */
-		Display_Handle->State = HD44780_TIMEOUT;
-		HD44780_Error_Handler(Display_Handle);
+		} /* Timing should have been enough, fall back to polling if it wasn't */
+
+		/* Exit once HD44780 is finished writing an instruction (busy flag isn't set) */
+		const uint32_t StartTick = HAL_GetTick();
+		do {
+			HD44780_Check_Status(Display_Handle);
+			if (Display_Handle->State != HD44780_BUSY) {
+				return;
+			} /* Ready, or the read itself failed */
+		} while ((HAL_GetTick() - StartTick) < HD44780_BUSY_TIMEOUT_MS);
+
+		/* >HD44780_BUSY_TIMEOUT_MS has passed at this point. Throw timeout error */
+		HD44780_STAT_ADD(Display_Handle, Timeouts, 1);
+		HD44780_Fault(Display_Handle, HD44780_TIMEOUT);
 	}
 
 	else {
+		if (ExecutionTime_us > Display_Handle->Transport->Leadin_us) {
+			HD44780_Wait_us(Display_Handle, ExecutionTime_us);
+		}
 		Display_Handle->State = HD44780_READY;
-	} /* Not checking busy flag */
+	} /* Not checking busy flag, wait out worst case execution time instead */
+}
+
+/**
+  * @brief 	Expands one instruction/data byte into the four PCF8574 port bytes needed to clock it
+  * 		into the HD44780 in 4-bit mode: upper nibble with EN HIGH then LOW, followed by the lower
+  * 		nibble. The PCF8574 latches every byte it receives (PCF8574 pg. 12), so the result can be
+  * 		handed to HD44780_Write_Burst() as-is. See HD44780 pg. 22, Figure 17.
+  * @param 	Buffer receiving the port bytes. Must hold at least 4 bytes.
+  * @param 	Byte to encode.
+  * @param 	Port bits kept constant for the whole byte (RS, RW, backlight).
+  * @retval Number of port bytes written.
+  */
+static uint8_t HD44780_Encode_Nibbles(uint8_t *Frame, uint8_t Value, uint8_t ControlBits)
+{
+	const uint8_t Value_7_4 = (0xF0 & Value);
+	const uint8_t Value_3_0 = (0xF0 & (Value<<4));
+
+	Frame[0] = (Value_7_4 | ControlBits | HD44780_EN);
+	Frame[1] = (Value_7_4 | ControlBits);
+	Frame[2] = (Value_3_0 | ControlBits | HD44780_EN);
+	Frame[3] = (Value_3_0 | ControlBits);
+	return 4;
 }
 
 /**
-  * @brief 	Executes when HD44780 timeout error occurs. Up to user
-  * 		on how to handle.
+  * @brief 	Writes a sequence of port bytes in a single transfer of the handle's transport, so START,
+  * 		address byte and STOP are only paid once per frame on the PCF8574. Every backend holds each
+  * 		byte longer than the 450ns EN pulse width and 80ns data setup time (HD44780 pg. 52).
+  * 		A failed transfer is retried HD44780_MAX_RETRIES times with a doubling backoff.
+  * 		Gives up with HD44780_Fault().
   * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Port bytes to send.
+  * @param 	Number of port bytes.
+  * @retval False if the frame couldn't be sent or the display is already lost.
   */
-static void HD44780_Error_Handler(HD44780_HandleTypeDef *Display_Handle)
+static bool HD44780_Write_Burst(HD44780_HandleTypeDef *Display_Handle, const uint8_t *Frame, uint16_t Length)
 {
-	__disable_irq();
-	while (Display_Handle->State != HD44780_READY) {
-		/* USER CODE BEGIN */
+	if (Display_Handle->Needs_Reinit) {
+		return false;
+	}
+
+	for (uint8_t Attempt = 0; Attempt <= HD44780_MAX_RETRIES; Attempt++) {
+		const HAL_StatusTypeDef Status = Display_Handle->Transport->Write(Display_Handle, Frame, Length);
+		HD44780_STAT_ADD(Display_Handle, Transactions, 1);
+		if (Status == HAL_OK) {
+			HD44780_STAT_ADD(Display_Handle, Tx_Bytes, Length);
+			Display_Handle->Port_Byte = Frame[Length - 1];
+			return true;
+		}
 
-		/*Display_Handle->State = HD44780_READY;*/
+		HD44780_STAT_ADD(Display_Handle, HAL_Errors, 1);
+		if (Attempt < HD44780_MAX_RETRIES) {
+			HD44780_Wait_us(Display_Handle, ((uint32_t)HD44780_RETRY_BACKOFF_US << Attempt));
+		}
 	}
-	/*__enable_irq(); */
-	/* USER CODE END */
+
+	HD44780_Fault(Display_Handle, HD44780_ERROR);
+	return false;
 }
 
 /**
-  * @brief 	Updates the current cursor position in Display_Handle->CursorPosition by direct read from
-  * 		LCD controller. See HD44780 pgs. 10-12 for how AddressCounter relates to the cursor's position.
-  * 		TODO - MAKE COMPATIBLE FOR ALL DISPLAYS (VARYING ROW/COLUMN COUNT)
-  * @param 	Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @brief 	Reads the port bits back in one transfer of the handle's transport, with the same retries
+  * 		as HD44780_Write_Burst(). See PCF8574 pg. 9.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Receives the port byte (P7..P0).
+  * @retval False if the read failed or the display is already lost.
   */
-static void HD44780_Get_Cursor_Position(HD44780_HandleTypeDef *Display_Handle)
+static bool HD44780_Read_Port(HD44780_HandleTypeDef *Display_Handle, uint8_t *PortByte)
 {
-	HD44780_Check_Status(Display_Handle); /* Read position directly from LCD */
-	const uint8_t AddressCopy = AddressCounter;
-
-	if (AddressCopy < 40) {
-		Display_Handle->Cursor_Position[0] = 0; /* First row */
-		Display_Handle->Cursor_Position[1] = AddressCopy;
+	if (Display_Handle->Needs_Reinit) {
+		return false;
 	}
 
-	else {
-		Display_Handle->Cursor_Position[0] = 1; /* Second row */
-		Display_Handle->Cursor_Position[1] = (uint8_t)(AddressCopy - 64);
+	for (uint8_t Attempt = 0; Attempt <= HD44780_MAX_RETRIES; Attempt++) {
+		const HAL_StatusTypeDef Status = Display_Handle->Transport->Read(Display_Handle, PortByte);
+		HD44780_STAT_ADD(Display_Handle, Transactions, 1);
+		if (Status == HAL_OK) {
+			HD44780_STAT_ADD(Display_Handle, Rx_Bytes, 1);
+			return true;
+		}
+
+		HD44780_STAT_ADD(Display_Handle, HAL_Errors, 1);
+		if (Attempt < HD44780_MAX_RETRIES) {
+			HD44780_Wait_us(Display_Handle, ((uint32_t)HD44780_RETRY_BACKOFF_US << Attempt));
+		}
 	}
+
+	HD44780_Fault(Display_Handle, HD44780_ERROR);
+	return false;
 }
 
 /**
-  * @brief 	Clears text stored in Display_Handle->Text.
-  * @param 	Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @brief 	Marks the display as lost: writes are dropped from now on while Text and the cursor
+  * 		position keep tracking what should be shown, and HD44780_Check_Health() re-initializes the
+  * 		display once it answers again. Never blocks.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	HD44780_TIMEOUT or HD44780_ERROR.
   */
-static void Clear_Text_Buffer(HD44780_HandleTypeDef *Display_Handle)
+static void HD44780_Fault(HD44780_HandleTypeDef *Display_Handle, HD44780_State State)
 {
-	for (int i = 0; i < HD44780_NUM_ELEMENTS; i++) {
-		Display_Handle->Text[i] = '\0';
-	}
+	Display_Handle->State = State;
+	Display_Handle->Needs_Reinit = true;
+	Display_Handle->Error_Tick = HAL_GetTick();
+	HD44780_Error_Handler(Display_Handle);
 }
 
-
-/* ########################## Public Functions ########################### */
 /**
-  * @brief  Meant for end user. Initializes HD44780 through software reset.
-  * 		See HD44780 pg. 46, Figure 24 for initialization sequence.
-  * @param  Pointer to HAL I2C_HandleTypeDef
-  * @param  Pointer to HD44780_HandleTypeDef struct.
-  * @retval Boolean indicating if initialization was successful.
+  * @brief 	Frees a bus held busy by a slave stuck in the middle of a byte: clocks SCL up to 9 times
+  * 		until SDA is released, then generates a STOP and re-initializes the I2C peripheral
+  * 		(HAL_I2C_MspInit() puts the pins back into alternate function mode). See UM10204 3.1.16.
+  * 		Only available when HD44780_SCL_GPIO_PORT and friends are defined.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
   */
-bool HD44780_Init(I2C_HandleTypeDef *I2C_Handle, HD44780_HandleTypeDef *Display_Handle)
+static void HD44780_Bus_Recovery(HD44780_HandleTypeDef *Display_Handle)
 {
-	if (HAL_I2C_IsDeviceReady(I2C_Handle, HW061_I2C_ADDR, 10, HAL_MAX_DELAY) == HAL_OK) {
-		HAL_Delay(45);
-		Display_Handle->HW061_I2C_Handle = I2C_Handle;
-		Display_Handle->Cursor_Position[0] = 0;
-		Display_Handle->Cursor_Position[1] = 0;
+#if defined(HD44780_SCL_GPIO_PORT) && defined(HD44780_SDA_GPIO_PORT)
+	GPIO_InitTypeDef Pin = {0};
+
+	HAL_I2C_DeInit(Display_Handle->HW061_I2C_Handle);
+	Pin.Mode = GPIO_MODE_OUTPUT_OD;
+	Pin.Pull = GPIO_NOPULL;
+	Pin.Speed = GPIO_SPEED_FREQ_LOW;
+	Pin.Pin = HD44780_SCL_GPIO_PIN;
+	HAL_GPIO_Init(HD44780_SCL_GPIO_PORT, &Pin);
+	Pin.Pin = HD44780_SDA_GPIO_PIN;
+	HAL_GPIO_Init(HD44780_SDA_GPIO_PORT, &Pin);
+
+	HAL_GPIO_WritePin(HD44780_SDA_GPIO_PORT, HD44780_SDA_GPIO_PIN, GPIO_PIN_SET);
+	HAL_GPIO_WritePin(HD44780_SCL_GPIO_PORT, HD44780_SCL_GPIO_PIN, GPIO_PIN_SET);
+	for (uint8_t Clock = 0; (Clock < 9) && (HAL_GPIO_ReadPin(HD44780_SDA_GPIO_PORT, HD44780_SDA_GPIO_PIN) == GPIO_PIN_RESET); Clock++) {
+		HAL_GPIO_WritePin(HD44780_SCL_GPIO_PORT, HD44780_SCL_GPIO_PIN, GPIO_PIN_RESET);
+		HD44780_Delay_us(5);
+		HAL_GPIO_WritePin(HD44780_SCL_GPIO_PORT, HD44780_SCL_GPIO_PIN, GPIO_PIN_SET);
+		HD44780_Delay_us(5);
+	} /* 100kHz clock pulses */
+
+	/* STOP: SDA rises while SCL is HIGH */
+	HAL_GPIO_WritePin(HD44780_SCL_GPIO_PORT, HD44780_SCL_GPIO_PIN, GPIO_PIN_RESET);
+	HAL_GPIO_WritePin(HD44780_SDA_GPIO_PORT, HD44780_SDA_GPIO_PIN, GPIO_PIN_RESET);
+	HD44780_Delay_us(5);
+	HAL_GPIO_WritePin(HD44780_SCL_GPIO_PORT, HD44780_SCL_GPIO_PIN, GPIO_PIN_SET);
+	HD44780_Delay_us(5);
+	HAL_GPIO_WritePin(HD44780_SDA_GPIO_PORT, HD44780_SDA_GPIO_PIN, GPIO_PIN_SET);
+	HD44780_Delay_us(5);
+
+	HAL_I2C_Init(Display_Handle->HW061_I2C_Handle);
+#else
+	(void)Display_Handle;
+#endif
+}
 
-		/* Must send commands in 8-bit mode */
-		uint8_t WriteCommand = (0x30 | HD44780_EN);
-		HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-		HAL_Delay(1); /* EN must be HIGH for at least 450ns, data setup time at least 80ns */
-		WriteCommand &= ~(HD44780_EN);
-		HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-		HAL_Delay(5);
-
-		WriteCommand |= HD44780_EN; /* Instruction = 0x30 */
-		HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-		HAL_Delay(1);
-		WriteCommand &= ~(HD44780_EN);
-		HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-		HAL_Delay(1);
-
-		WriteCommand |= HD44780_EN; /* Instruction = 0x30 */
-		HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-		HAL_Delay(1);
-		WriteCommand &= ~(HD44780_EN);
-		HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-		HAL_Delay(1);
-
-		WriteCommand = (0x20 | HD44780_EN); /* Instruction = 0x20 */
-		HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-		HAL_Delay(1);
-		WriteCommand &= ~(HD44780_EN);
-		HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &WriteCommand, 1, 200);
-		HAL_Delay(1);
-
-		/* Can now send commands in 4-bit mode */
-		WriteCommand = HD44780_FUNCTION_SET; /* CURRENTLY ONLY SUPPORT 4-BIT MODE */
-			if (HD44780_NUM_ROWS == 2) {
-				WriteCommand |= (1<<3);
-			} /* else 1 row used */
-
-		HD44780_Send_Command(Display_Handle, WriteCommand, true); /* 4-bit mode, num of rows, 5x8 character font */
-
-		HD44780_Send_Command(Display_Handle, 0x08, true); /* Turn display off */
-
-		HD44780_Send_Command(Display_Handle, 0x01, true); /* Clear display */
-
-		HD44780_Send_Command(Display_Handle, 0x06, true); /* Auto-increment, no display shift */
-
-		HD44780_Send_Command(Display_Handle, 0x0C, true); /* Turn display on */
-		/* END OF SOFTWARE RESET */
-
-		HD44780_Transmit_Command(Display_Handle, CURSOR_ON);
-		Display_Handle->PowerState = LCD1602_ON;
-		return true;
+#if (HD44780_TRACE_DEPTH > 0)
+/**
+  * @brief 	Appends a timestamped record to the trace ring, overwriting the oldest one when it is full.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Kind of record.
+  * @param 	Instruction, character or status byte.
+  */
+static void HD44780_Trace_Record(HD44780_HandleTypeDef *Display_Handle, HD44780_Trace_Type Type, uint8_t Value)
+{
+	HD44780_TraceTypeDef *Record = &Display_Handle->Trace[Display_Handle->Trace_Head];
+
+	Record->Timestamp = HD44780_Get_Timestamp();
+	Record->Type = Type;
+	Record->Value = Value;
+	Display_Handle->Trace_Head = (uint16_t)((Display_Handle->Trace_Head + 1) % HD44780_TRACE_DEPTH);
+	if (Display_Handle->Trace_Count < HD44780_TRACE_DEPTH) {
+		Display_Handle->Trace_Count++;
 	}
-
-	else {
-		return false;
-	} /* No established I2C connection with slave device */
 }
+#endif
 
 /**
-  * @brief Meant for end-user. Sends pre-defined commands to HD44780.
-  * @param Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
-  * @param UserCommand from enum HD44780_User_Command_List (CLEAR_DISPLAY, RETURN_HOME, ...)
+  * @brief 	Prepares the delay backend selected by HD44780_DELAY_BACKEND. Enables the DWT cycle counter
+  * 		(Cortex-M3 TRM pg. 11-2) or starts the user's 1MHz timer. Nothing to do for HAL_Delay().
   */
-void HD44780_Transmit_Command(HD44780_HandleTypeDef *Display_Handle, HD44780_User_Command_List UserCommand)
+static void HD44780_Delay_Init(void)
 {
-	uint8_t Command;
-
-	if (Display_Handle->PowerState == LCD1602_ON) {
-		switch(UserCommand) {
-			case CLEAR_DISPLAY:
-				Command = 0x01;
-				HD44780_Send_Command(Display_Handle, Command, true);
-				Clear_Text_Buffer(Display_Handle);
-				Display_Handle->Cursor_Position[0] = 0;
-				Display_Handle->Cursor_Position[1] = 0;
-				break;
-
-			case RETURN_HOME:
-				Command = 0x02;
-				HD44780_Send_Command(Display_Handle, Command, true);
-				Display_Handle->Cursor_Position[0] = 0;
-				Display_Handle->Cursor_Position[1] = 0;
-				break;
-
-			case DISPLAY_OFF:
-				Command = 0;
-				HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &Command, 1, 200);
-				Display_Handle->PowerState = LCD1602_OFF;
-				break;
-
-			case CURSOR_ON:
-				Command = 0x0E;
-				HD44780_Send_Command(Display_Handle, Command, true);
-				break;
-
-			case CURSOR_OFF:
-				Command = 0x0C;
-				HD44780_Send_Command(Display_Handle, Command, true);
-				break;
-
-			case CURSOR_BLINK:
-				Command = 0x0D;
-				HD44780_Send_Command(Display_Handle, Command, true);
-				break;
+#if (HD44780_DELAY_BACKEND == HD44780_DELAY_DWT)
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#elif (HD44780_DELAY_BACKEND == HD44780_DELAY_TIM)
+	HAL_TIM_Base_Start(&HD44780_DELAY_TIM_HANDLE);
+#endif
+}
 
-			case CURSOR_UNBLINK:
-				Command = 0x0C;
-				HD44780_Send_Command(Display_Handle, Command, true);
-				break;
+/**
+  * @brief 	Waits for at least the given number of microseconds using the backend selected by
+  * 		HD44780_DELAY_BACKEND. The HAL backend rounds up to whole SysTick milliseconds. With
+  * 		HD44780_USE_RTOS waits of 1ms and longer block the task instead, see HD44780_Delay_ms().
+  * @param 	Minimum wait time in microseconds.
+  */
+static void HD44780_Delay_us(uint32_t Microseconds)
+{
+#if (HD44780_USE_RTOS == 1)
+	if (Microseconds >= 1000U) {
+		HD44780_Delay_ms((Microseconds + 999U) / 1000U);
+		return;
+	} /* Clear display, software reset: long enough to hand the CPU to other tasks */
+#endif
+
+#if (HD44780_DELAY_BACKEND == HD44780_DELAY_HAL)
+	HD44780_Delay_ms((Microseconds + 999U) / 1000U);
+#else
+	HD44780_Spin_us(Microseconds);
+#endif
+}
 
-			default:
-				break;
-		}
+/**
+  * @brief 	Busy-waits for at least the given number of microseconds on the backend selected by
+  * 		HD44780_DELAY_BACKEND, also with HD44780_USE_RTOS. For waits that must not be rounded to
+  * 		kernel ticks, like the samples of HD44780_Calibrate(). The HAL backend spins in HAL_Delay().
+  * @param 	Minimum wait time in microseconds.
+  */
+static void HD44780_Spin_us(uint32_t Microseconds)
+{
+#if (HD44780_DELAY_BACKEND == HD44780_DELAY_DWT)
+	const uint32_t Start = DWT->CYCCNT;
+	const uint32_t Cycles = (Microseconds * (SystemCoreClock / 1000000U));
+	while ((DWT->CYCCNT - Start) < Cycles) {
+		/* Unsigned subtraction handles CYCCNT wrap-around */
 	}
 
-	else if (Display_Handle->PowerState == LCD1602_OFF) {
-		switch (UserCommand) {
-			case DISPLAY_ON:
-				Command = HD44780_BACKLIGHT;
-				HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, HW061_I2C_ADDR, &Command, 1, 200);
-				Display_Handle->PowerState = LCD1602_ON;
-				break;
-
-			default:
-				break;
+#elif (HD44780_DELAY_BACKEND == HD44780_DELAY_TIM)
+	while (Microseconds > 0) {
+		const uint16_t Chunk = (Microseconds > 0xFFFF) ? 0xFFFF : (uint16_t)Microseconds;
+		const uint16_t Start = (uint16_t)__HAL_TIM_GET_COUNTER(&HD44780_DELAY_TIM_HANDLE);
+		while ((uint16_t)(__HAL_TIM_GET_COUNTER(&HD44780_DELAY_TIM_HANDLE) - Start) < Chunk) {
+			/* 16-bit counter, unsigned subtraction handles wrap-around */
 		}
+		Microseconds -= Chunk;
 	}
+
+#else
+	HAL_Delay((Microseconds + 999U) / 1000U);
+#endif
 }
 
 /**
-  * @brief 	Meant for end-user. Prints text to the LCD starting at current
-  * 		cursor position. Automatically goes to new row when there's no more display
-  * 		room on the 1st row. Stops printing and sets cursor to (0,0) if there's no more
-  * 		display room.
-  * 		TODO - MAKE COMPATIBLE FOR ALL DISPLAYS (VARYING ROW/COLUMN COUNT)
-  * @param 	Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
-  * @param 	String to print.
+  * @brief 	Millisecond wait: HAL_Delay(), or the RTOS port's blocking delay when HD44780_USE_RTOS is 1.
+  * @param 	Milliseconds to wait.
   */
-void HD44780_Print(HD44780_HandleTypeDef *Display_Handle, const char *str)
+static void HD44780_Delay_ms(uint32_t Milliseconds)
 {
-	HD44780_Get_Cursor_Position(Display_Handle);
-	uint8_t row = Display_Handle->Cursor_Position[0];
-	uint8_t column = Display_Handle->Cursor_Position[1];
-	uint8_t startindex = ((row * HD44780_NUM_COLS) + column);; /*Find index where text ends in Display_Handle->Text */
-
-	for (int i = 0; i < strlen(str); i++) {
-		if ((startindex + i) > (HD44780_NUM_ELEMENTS - 1)) { /* No more display room */
-			HD44780_Set_Cursor_Position(Display_Handle, 0, 0);
-			return;
-		}
+#if (HD44780_USE_RTOS == 1)
+	HD44780_RTOS_Delay_ms(Milliseconds);
+#else
+	HAL_Delay(Milliseconds);
+#endif
+}
 
-		HD44780_Send_Data(Display_Handle, (uint8_t)str[i], true); /* Updates AddressCounter automatically */
-		Display_Handle->Text[startindex + i] = str[i];
+/**
+  * @brief 	Waits for at least the given number of microseconds the way Display_Handle->Wait_Mode asks.
+  * 		HD44780_WAIT_SLEEP sleeps on WFI while more than HD44780_SLEEP_WAKE_US are left and spins
+  * 		the rest, so waits below one SysTick period (37us instructions) still spin. Sleeping is
+  * 		skipped with interrupts masked, and with HD44780_USE_RTOS for waits osDelay() already idles.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Minimum wait time in microseconds.
+  */
+static void HD44780_Wait_us(HD44780_HandleTypeDef *Display_Handle, uint32_t Microseconds)
+{
+#if (HD44780_USE_RTOS == 1)
+	const bool Yields = (Microseconds >= 1000U);
+#else
+	const bool Yields = false;
+#endif
+	uint32_t Slept_us = 0;
+
+	if ((Display_Handle->Wait_Mode == HD44780_WAIT_SLEEP) && !Yields && (__get_PRIMASK() == 0U)) {
+		Slept_us = HD44780_Sleep_us(Microseconds);
+		HD44780_STAT_ADD(Display_Handle, Sleep_Time, Slept_us);
+	}
 
-		if (AddressCounter == HD44780_NUM_COLS) { /* end of first row, go to second row */
-			HD44780_Set_Cursor_Position(Display_Handle, 1, 0);
-		}
+	if (Slept_us < Microseconds) {
+		HD44780_Delay_us(Microseconds - Slept_us);
+		HD44780_STAT_ADD(Display_Handle, Spin_Time, (Microseconds - Slept_us));
 	}
-	HD44780_Get_Cursor_Position(Display_Handle); /* Update cursor position at end */
 }
 
 /**
-  * @brief  Meant for end-user. Sets the cursor position WILL NOT WORK IF
-  * 		DISPLAY IS LEFT OR RIGHT SHIFTED AT ANY POINT.
-  * 		TODO - MAKE COMPATIBLE FOR ALL DISPLAYS (VARYING ROW/COLUMN COUNT)
-  * @param 	Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
-  * @param 	Row index (0-indexed).
-  * @param 	Column index (0-indexed).
+  * @brief 	Sleeps on WFI until at most HD44780_SLEEP_WAKE_US of the wait are left. SysTick always
+  * 		wakes the core within one period, so the deadline is never overslept.
+  * @param 	Wait time in microseconds.
+  * @retval Microseconds that passed while sleeping.
   */
-void HD44780_Set_Cursor_Position(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column)
+static uint32_t HD44780_Sleep_us(uint32_t Microseconds)
 {
-	uint8_t Command;
-	if ((row >= HD44780_NUM_ROWS) | (column >= HD44780_NUM_COLS)) {
-		return;
+	const uint32_t Start = HD44780_Sleep_Clock_us();
+	int32_t Elapsed = 0;
+
+	while (((uint32_t)Elapsed + HD44780_SLEEP_WAKE_US) < Microseconds) {
+		__WFI();
+		Elapsed = (int32_t)(HD44780_Sleep_Clock_us() - Start);
+		if (Elapsed < 0) {
+			Elapsed = 0;
+		} /* Read across a reload before its interrupt ran */
 	}
 
-	else{
-		if (row == 0){
-			Command = (0x80 | column);
-			HD44780_Send_Command(Display_Handle, Command, true);
-		}
-
-		else{
-			Command = (0x80 | 0x40 | column);
-			HD44780_Send_Command(Display_Handle, Command, true);
-		}
-	}
+	return (uint32_t)Elapsed;
 }
 
 /**
-  * @brief  Meant for end-user. Retrieves the character on LCD display at specified coordinates.
-  * TODO - MAKE COMPATIBLE FOR ALL DISPLAYS (VARYING ROW/COLUMN COUNT)
-  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
-  * @param	Row coordinate.
-  * @param	Column coordinate.
-  * @retval Character at specified coordinate.
+  * @brief 	Microsecond clock built from the HAL tick and the SysTick down counter. Unlike the DWT cycle
+  * 		counter it keeps running while the core sleeps.
+  * @retval Microseconds, wraps around after 2^32.
   */
-char HD44780_Read_Character(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column)
+static uint32_t HD44780_Sleep_Clock_us(void)
 {
-	if ((row >= HD44780_NUM_ROWS) | (column >= HD44780_NUM_COLS)) {
-		return 0;
-	}
+	uint32_t Tick;
+	uint32_t Count;
 
-	else {
-		uint8_t index = ((row * HD44780_NUM_COLS) + column);
-		return (Display_Handle->Text[index]);
-	}
+	do {
+		Tick = HAL_GetTick();
+		Count = SysTick->VAL;
+	} while (Tick != HAL_GetTick()); /* SysTick interrupt in between */
 
+	const uint32_t Reload = SysTick->LOAD + 1U;
+	return (Tick * 1000U) + (uint32_t)(((uint64_t)(Reload - 1U - Count) * HD44780_SLEEP_WAKE_US) / Reload);
 }
 
 /**
-  * @brief  Meant for end-user. Retrieves the current row number the cursor is on.
-  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
-  * @retval Current row (0-indexed).
+  * @brief 	Returns the worst case execution time of an instruction. Clear display and return home
+  * 		take Display_Handle->Clear_Time_us, everything else Display_Handle->Exec_Time_us.
+  * 		See HD44780 pg. 24, Table 6.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Instruction byte (RS = LOW).
+  * @retval Execution time in microseconds.
   */
-uint8_t HD44780_Get_Row_Index(HD44780_HandleTypeDef *Display_Handle)
+static uint32_t HD44780_Get_Execution_Time(HD44780_HandleTypeDef *Display_Handle, uint8_t Command)
 {
-	return Display_Handle->Cursor_Position[0];
+	if ((Command == 0x01) | ((Command & 0xFE) == 0x02)) {
+		return Display_Handle->Clear_Time_us;
+	} /* Clear display or return home */
+
+	return Display_Handle->Exec_Time_us;
 }
 
 /**
-  * @brief  Meant for end-user. Retrieves the current column number the cursor is on.
-  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
-  * @retval Current column (0-indexed).
+  * @brief 	Sets one of the shadowed instruction registers (function set, entry mode, display control).
+  * 		Nothing is sent if the HD44780 already holds the value.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Shadow of the register in the handle.
+  * @param 	Instruction including its instruction bit, e.g. HD44780_DISPLAY_CONTROL | HD44780_DISPLAY_BIT.
   */
-uint8_t HD44780_Get_Column_Index(HD44780_HandleTypeDef *Display_Handle)
+static void HD44780_Write_Register(HD44780_HandleTypeDef *Display_Handle, uint8_t *Shadow, uint8_t Value)
 {
-	return Display_Handle->Cursor_Position[1];
+	if (*Shadow == Value) {
+		return;
+	}
+
+	*Shadow = Value;
+	HD44780_Send_Command(Display_Handle, Value, true);
 }
 
 /**
-  * @brief  Meant for end-user. Scrolls LCD text from left to right. See HD44780 pgs. 10-12 and 27.
-  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
-  * @param	Number of times to scroll the text across the LCD.
+  * @brief 	Switches the backlight. Every later port byte carries the new state, the port is only
+  * 		written here if it changes.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	HD44780_BACKLIGHT or 0.
   */
-void HD44780_Animate_Text(HD44780_HandleTypeDef *Display_Handle, uint8_t NumberOfScrolls)
+static void HD44780_Set_Backlight(HD44780_HandleTypeDef *Display_Handle, uint8_t Backlight)
 {
+	if (Display_Handle->Backlight == Backlight) {
+		return;
+	}
 
-	bool TextPresent = false;
-	for (int i = 0; i < HD44780_NUM_ELEMENTS; i++) {
-		if (Display_Handle->Text[i] != 0){
-			TextPresent = true;
-			break;
+	Display_Handle->Backlight = Backlight;
+	HD44780_Write_Port(Display_Handle, Backlight);
+}
+
+/**
+  * @brief 	Writes a single raw byte to the PCF8574 port, e.g. to switch the backlight.
+  * 		Goes through the transmit queue when it is enabled.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Port byte (P7..P0).
+  */
+static void HD44780_Write_Port(HD44780_HandleTypeDef *Display_Handle, uint8_t PortByte)
+{
+#if (HD44780_USE_ASYNC == 1)
+	if (Display_Handle->Async_Enabled) {
+		HD44780_Queue_Frame(Display_Handle, &PortByte, 1, 0, false);
+		return;
+	}
+#endif
+
+	HD44780_Write_Burst(Display_Handle, &PortByte, 1);
+}
+
+#if (HD44780_USE_ASYNC == 1)
+/**
+  * @brief 	Checks if at least the given time has passed since a timestamp. The millisecond
+  * 		fallback adds a tick since the first one may be partial.
+  * @param 	Timestamp from HD44780_Get_Timestamp().
+  * @param 	Minimum time in microseconds.
+  * @retval True once the time has passed.
+  */
+static bool HD44780_Time_Elapsed(uint32_t Timestamp, uint32_t Microseconds)
+{
+#if (HD44780_DELAY_BACKEND == HD44780_DELAY_DWT)
+	return ((DWT->CYCCNT - Timestamp) >= (Microseconds * (SystemCoreClock / 1000000U)));
+#else
+	return ((HAL_GetTick() - Timestamp) > ((Microseconds + 999U) / 1000U));
+#endif
+}
+
+/**
+  * @brief 	Adds a frame of port bytes to the handle's transmit queue and starts the transfer if the
+  * 		bus is idle. Mergeable frames (data writes) are appended to the last queued frame when it
+  * 		hasn't been started yet, dropping the repeated RS setup byte. Back to back characters in one
+  * 		transfer are still >2 I2C bytes apart, well above the 37us execution time. Waits in
+  * 		HD44780_Service_Queue() and HD44780_Wait_Slot() only when the queue is full.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Port bytes of the frame.
+  * @param 	Number of port bytes (at most HD44780_QUEUE_FRAME_LEN).
+  * @param 	Time the HD44780 needs after this frame before the next one may start.
+  * @param 	True if the frame may be merged with a preceding mergeable frame.
+  */
+static void HD44780_Queue_Frame(HD44780_HandleTypeDef *Display_Handle, const uint8_t *Frame, uint8_t Length, uint32_t Delay_us, bool Mergeable)
+{
+	while (true) {
+		const uint32_t PriMask = __get_PRIMASK();
+		__disable_irq();
+
+		if (Mergeable && (Display_Handle->Queue_Count > 0)) {
+			const uint8_t Last = (uint8_t)((Display_Handle->Queue_Tail + HD44780_QUEUE_DEPTH - 1) % HD44780_QUEUE_DEPTH);
+			HD44780_FrameTypeDef *Slot = &Display_Handle->Queue[Last];
+			const bool InFlight = (Display_Handle->Queue_Active && (Last == Display_Handle->Queue_Head));
+
+			if (Slot->Mergeable && !InFlight && ((Slot->Length + Length - 1) <= HD44780_QUEUE_FRAME_LEN)) {
+				memcpy(&Slot->Bytes[Slot->Length], &Frame[1], (size_t)(Length - 1));
+				Slot->Length += (uint8_t)(Length - 1);
+				__set_PRIMASK(PriMask);
+				return;
+			}
+		}
+
+		if (Display_Handle->Queue_Count < HD44780_QUEUE_DEPTH) {
+			HD44780_FrameTypeDef *Slot = &Display_Handle->Queue[Display_Handle->Queue_Tail];
+			memcpy(Slot->Bytes, Frame, Length);
+			Slot->Length = Length;
+			Slot->Delay_us = (uint16_t)Delay_us;
+			Slot->Mergeable = Mergeable;
+			Display_Handle->Queue_Tail = (uint8_t)((Display_Handle->Queue_Tail + 1) % HD44780_QUEUE_DEPTH);
+			Display_Handle->Queue_Count++;
+			Display_Handle->State = HD44780_BUSY;
+			__set_PRIMASK(PriMask);
+			HD44780_Service_Queue(Display_Handle);
+			return;
+		}
+
+		__set_PRIMASK(PriMask);
+		HD44780_Service_Queue(Display_Handle); /* Queue full, wait for a slot */
+		HD44780_Wait_Slot(Display_Handle);
+	}
+}
+
+/**
+  * @brief 	Starts transmitting the oldest queued frame. Called with interrupts disabled or from the
+  * 		I2C interrupt. Leaves the queue alone if the bus is still in use.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Queue_Start(HD44780_HandleTypeDef *Display_Handle)
+{
+	HD44780_FrameTypeDef *Slot = &Display_Handle->Queue[Display_Handle->Queue_Head];
+	HAL_StatusTypeDef Status;
+
+	Display_Handle->Queue_Active = true;
+#if (HD44780_ASYNC_METHOD == HD44780_ASYNC_DMA)
+	Status = HAL_I2C_Master_Transmit_DMA(Display_Handle->HW061_I2C_Handle, Display_Handle->I2C_Address, Slot->Bytes, Slot->Length);
+#else
+	Status = HAL_I2C_Master_Transmit_IT(Display_Handle->HW061_I2C_Handle, Display_Handle->I2C_Address, Slot->Bytes, Slot->Length);
+#endif
+
+	if (Status != HAL_OK) {
+		Display_Handle->Queue_Active = false;
+		HD44780_STAT_ADD(Display_Handle, HAL_Errors, 1);
+	} /* Bus busy, HD44780_Service_Queue() retries */
+
+	else {
+		HD44780_STAT_ADD(Display_Handle, Tx_Bytes, Slot->Length);
+		HD44780_STAT_ADD(Display_Handle, Transactions, 1);
+	}
+}
+
+/**
+  * @brief 	Adds the handle to the list searched by the HAL I2C callbacks.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Register_Handle(HD44780_HandleTypeDef *Display_Handle)
+{
+	for (uint8_t i = 0; i < HD44780_MAX_DISPLAYS; i++) {
+		if ((Async_Handles[i] == Display_Handle) | (Async_Handles[i] == NULL)) {
+			Async_Handles[i] = Display_Handle;
+			return;
+		}
+	}
+}
+/**
+  * @brief 	Bus scheduler. Starts the first ready frame among the displays sharing an I2C bus, unless a
+  * 		transfer is already in flight there. A display holding off for a long execution time is
+  * 		skipped so it doesn't block the others. Called with interrupts disabled or from the I2C
+  * 		interrupt.
+  * @param 	Pointer to HAL I2C_HandleTypeDef of the bus.
+  * @param 	Index in the display list to start searching from (round robin).
+  */
+static void HD44780_Schedule_Bus(I2C_HandleTypeDef *hi2c, uint8_t First)
+{
+	for (uint8_t i = 0; i < HD44780_MAX_DISPLAYS; i++) {
+		const HD44780_HandleTypeDef *Display_Handle = Async_Handles[i];
+		if ((Display_Handle != NULL) && (Display_Handle->HW061_I2C_Handle == hi2c) && Display_Handle->Queue_Active) {
+			return;
+		}
+	} /* Bus in use */
+
+	for (uint8_t n = 0; n < HD44780_MAX_DISPLAYS; n++) {
+		HD44780_HandleTypeDef *Display_Handle = Async_Handles[(First + n) % HD44780_MAX_DISPLAYS];
+
+		if ((Display_Handle == NULL) || (Display_Handle->HW061_I2C_Handle != hi2c) || (Display_Handle->Queue_Count == 0)) {
+			continue;
+		}
+
+		if (Display_Handle->Queue_Waiting && HD44780_Time_Elapsed(Display_Handle->Queue_Timestamp, Display_Handle->Queue_Delay_us)) {
+			Display_Handle->Queue_Waiting = false;
+		}
+
+		if (!Display_Handle->Queue_Waiting) {
+			HD44780_Queue_Start(Display_Handle);
+			if (Display_Handle->Queue_Active) {
+				return;
+			}
+		}
+	}
+}
+
+/**
+  * @brief 	Services the transmit queues of every display on the same I2C bus as Display_Handle:
+  * 		starts the next frame once the bus is idle and the previous instruction (e.g. clear
+  * 		display) has finished executing. Frames are chained from the I2C interrupt on their own,
+  * 		this only has to run from HD44780_Process() so frames held back by a long execution time go out.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Service_Queue(HD44780_HandleTypeDef *Display_Handle)
+{
+	const uint32_t PriMask = __get_PRIMASK();
+	__disable_irq();
+	HD44780_Schedule_Bus(Display_Handle->HW061_I2C_Handle, 0);
+	__set_PRIMASK(PriMask);
+}
+
+/**
+  * @brief 	Sleeps until the next interrupt while the transmit queue is full, in HD44780_WAIT_SLEEP.
+  * 		The queue is checked with interrupts masked: a completion that arrives before WFI stays
+  * 		pending and wakes the core at once, so no wake-up is lost. SysTick ends a sleep that no
+  * 		transfer ends (clear display holding the queue).
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Wait_Slot(HD44780_HandleTypeDef *Display_Handle)
+{
+	if ((Display_Handle->Wait_Mode != HD44780_WAIT_SLEEP) || (__get_PRIMASK() != 0U)) {
+		return;
+	} /* Spin on the queue, nothing could wake the core with interrupts masked */
+
+#if (HD44780_USE_STATS == 1)
+	const uint32_t Start = HD44780_Sleep_Clock_us();
+#endif
+	__disable_irq();
+	if (Display_Handle->Queue_Count == HD44780_QUEUE_DEPTH) {
+		__WFI();
+	}
+	__enable_irq();
+	HD44780_STAT_ADD(Display_Handle, Sleep_Time, (HD44780_Sleep_Clock_us() - Start));
+}
+#endif /* HD44780_USE_ASYNC */
+
+/**
+  * @brief 	Software reset of the HD44780 into 4-bit mode with the handle's line count, display and
+  * 		cursor on, cleared and auto-increment. The register shadows are set to match. Works from
+  * 		any state, including the middle of a 4-bit transfer, since it starts with three 8-bit
+  * 		function sets. Sends the precomputed HD44780_Init_Sequence[], one transfer per step. See
+  * 		HD44780 pg. 46, Figure 24.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Software_Reset(HD44780_HandleTypeDef *Display_Handle)
+{
+	Display_Handle->Function_Set = (HD44780_FUNCTION_SET | ((Display_Handle->Rows == 1) ? 0 : HD44780_TWO_LINES));
+	Display_Handle->Entry_Mode = (HD44780_ENTRY_MODE_SET | HD44780_INCREMENT);
+	Display_Handle->Display_Control = (HD44780_DISPLAY_CONTROL | HD44780_DISPLAY_BIT | HD44780_CURSOR_BIT);
+
+	for (uint8_t Step = 0; Step < HD44780_INIT_STEPS; Step++) {
+		const HD44780_Init_StepTypeDef *Init = &HD44780_Init_Sequence[Step];
+		const uint8_t *Bytes = ((Step == HD44780_INIT_SETUP_STEP) && (Display_Handle->Rows == 1)) ? HD44780_Init_Setup_1Line : Init->Bytes;
+		uint8_t Sent = 0;
+
+		if (Init->Busy_Flag) {
+			for (uint8_t i = 0; i < Init->Length; i += HD44780_COMMAND_FRAME_LEN) {
+				HD44780_TRACE(Display_Handle, HD44780_TRACE_COMMAND, ((Bytes[i] & 0xF0) | (Bytes[i + 2] >> 4)));
+			}
+
+			while ((Display_Handle->Transport->Leadin_us < Display_Handle->Exec_Time_us) && ((Init->Length - Sent) > HD44780_COMMAND_FRAME_LEN)) {
+				if (!HD44780_Write_Burst(Display_Handle, &Bytes[Sent], HD44780_COMMAND_FRAME_LEN)) {
+					return;
+				}
+				HD44780_Wait_us(Display_Handle, Display_Handle->Exec_Time_us);
+				Sent += HD44780_COMMAND_FRAME_LEN;
+			} /* Bus too fast to cover the execution time between instructions of one step */
+		}
+
+		if (!HD44780_Write_Burst(Display_Handle, &Bytes[Sent], (Init->Length - Sent))) {
+			return;
+		}
+
+		uint32_t Wait_us = Init->Wait_us;
+		if (Wait_us == 0) {
+			const uint8_t Last = (uint8_t)((Bytes[Init->Length - 4] & 0xF0) | (Bytes[Init->Length - 2] >> 4));
+			Wait_us = HD44780_Get_Execution_Time(Display_Handle, Last);
+		} /* 4-bit steps end on a full instruction */
+
+		Display_Handle->State = HD44780_BUSY;
+		HD44780_Wait_Execution(Display_Handle, Wait_us, Init->Busy_Flag);
+	}
+
+	Display_Handle->AddressCounter = 0; /* Cleared */
+	Display_Handle->Stale_Rows = 0; /* DDRAM is blank */
+}
+
+#if (HD44780_WARM_RESTART == 1)
+/**
+  * @brief 	Checks whether the HD44780 is still set up from before an MCU reset (power kept, 4-bit mode,
+  * 		nibbles in step). Reads the busy flag, sets the DDRAM address to HD44780_PROBE_ADDRESS and
+  * 		reads it back. A controller still in 8-bit mode after power on executes the two nibbles as
+  * 		separate instructions and reads back 0x22, one that is still busy with its internal reset
+  * 		or out of step answers with garbage. Either way the caller falls back to the software reset.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @retval True if HD44780_Warm_Restart() is enough.
+  */
+static bool HD44780_Probe_Warm(HD44780_HandleTypeDef *Display_Handle)
+{
+	if (!Display_Handle->Transport->Can_Read(Display_Handle)) {
+		return false;
+	} /* Nothing to read the address counter with */
+
+	HD44780_Check_Status(Display_Handle);
+	if (Display_Handle->Needs_Reinit || (Display_Handle->State == HD44780_BUSY)) {
+		return false;
+	}
+
+	HD44780_Send_Command(Display_Handle, (0x80 | HD44780_PROBE_ADDRESS), false); /* Timed, the busy flag isn't trusted yet */
+	HD44780_Check_Status(Display_Handle);
+
+	return (!Display_Handle->Needs_Reinit && (Display_Handle->State == HD44780_READY)
+			&& (Display_Handle->AddressCounter == HD44780_PROBE_ADDRESS));
+}
+
+/**
+  * @brief 	Fast path of HD44780_Init_Display() for a controller that passed HD44780_Probe_Warm().
+  * 		Only reasserts function set, entry mode and display control, DDRAM keeps showing what was
+  * 		there before the MCU reset. Every row is marked stale so the next HD44780_Flush() rewrites it.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Warm_Restart(HD44780_HandleTypeDef *Display_Handle)
+{
+	uint8_t WriteCommand = HD44780_FUNCTION_SET;
+	if (Display_Handle->Rows > 1) {
+		WriteCommand |= HD44780_TWO_LINES;
+	} /* Same line count as HD44780_Software_Reset() */
+
+	Display_Handle->Function_Set = 0; /* Unknown, make every register write go out */
+	Display_Handle->Entry_Mode = 0;
+	Display_Handle->Display_Control = 0;
+	HD44780_Write_Register(Display_Handle, &Display_Handle->Function_Set, WriteCommand);
+
+	HD44780_Write_Register(Display_Handle, &Display_Handle->Entry_Mode, (HD44780_ENTRY_MODE_SET | HD44780_INCREMENT)); /* Auto-increment, no display shift */
+
+	HD44780_Write_Register(Display_Handle, &Display_Handle->Display_Control, (HD44780_DISPLAY_CONTROL | HD44780_DISPLAY_BIT | HD44780_CURSOR_BIT)); /* Display and cursor on */
+
+	HD44780_Send_Command(Display_Handle, 0x80, true); /* Cursor home without the return home execution time */
+	Display_Handle->Stale_Rows = (uint8_t)((1 << Display_Handle->Rows) - 1);
+}
+#endif /* HD44780_WARM_RESTART */
+
+/**
+  * @brief 	Rebuilds the display after a re-init: uploads the resident glyphs again, writes every
+  * 		non-blank cell of Text, reloads hardware scrolled lines and puts the cursor back.
+  * 		HD44780_Check_Health() restores the display control register.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Restore_Display(HD44780_HandleTypeDef *Display_Handle)
+{
+	const uint8_t CursorRow = Display_Handle->Cursor_Position[0];
+	const uint8_t CursorColumn = Display_Handle->Cursor_Position[1];
+
+	for (uint8_t Slot = 0; Slot < HD44780_GLYPH_SLOTS; Slot++) {
+		if (Display_Handle->Glyph_Slot[Slot] != NULL) {
+			Display_Handle->Glyph_Pending |= (uint8_t)(1 << Slot);
+		}
+	}
+	HD44780_Glyph_Upload(Display_Handle);
+
+#if (HD44780_USE_SHADOW == 1)
+	for (uint8_t row = 0; row < Display_Handle->Rows; row++) {
+		for (uint8_t column = 0; column < Display_Handle->Cols; column++) {
+			const char Shown = Display_Handle->Text[(row * Display_Handle->Cols) + column];
+			if (HD44780_Cell_Matches(Shown, ' ')) {
+				continue;
+			} /* Already blank after clear display */
+
+			if (Display_Handle->AddressCounter != HD44780_Get_Address(Display_Handle, row, column)) {
+				HD44780_Send_Command(Display_Handle, (0x80 | HD44780_Get_Address(Display_Handle, row, column)), HD44780_Uses_Busy_Flag(Display_Handle));
+			}
+			HD44780_Send_Data(Display_Handle, (uint8_t)Shown, HD44780_Uses_Busy_Flag(Display_Handle));
+		}
+	}
+#endif /* Without the shadow the display comes back blank */
+
+#if (HD44780_FRAME_BUFFERS > 0)
+	if (Display_Handle->Canvas != NULL) {
+		HD44780_CanvasTypeDef *Canvas = Display_Handle->Canvas;
+		const uint16_t Column = Canvas->View_Column;
+		Canvas->View_Column = Display_Handle->Canvas_Column;
+		Display_Handle->Scroll_Hardware = false;
+		Display_Handle->Scroll_Shift = 0;
+		HD44780_Canvas_Load(Display_Handle, Canvas);
+		HD44780_Canvas_Shift(Display_Handle, Column);
+		Canvas->View_Column = Column;
+	} /* Text holds the columns loaded at DDRAM column 0, reload the hidden part and shift back to the view */
+
+	else if (Display_Handle->Scroll_Hardware) {
+		Display_Handle->Scroll_Hardware = false;
+		Display_Handle->Scroll_Shift = 0;
+		HD44780_Scroll_Select(Display_Handle);
+	} /* Display shift was lost with the reset */
+#endif
+
+	HD44780_Send_Command(Display_Handle, (0x80 | HD44780_Get_Address(Display_Handle, CursorRow, CursorColumn)), HD44780_Uses_Busy_Flag(Display_Handle)); /* Also drops the backlight again if it was off */
+	Display_Handle->Cursor_Position[0] = CursorRow;
+	Display_Handle->Cursor_Position[1] = CursorColumn;
+}
+
+/**
+  * @brief 	Called at the start of every public function that talks to the display. Once a fault
+  * 		is older than HD44780_REINIT_INTERVAL_MS, probes the PCF8574 with a single address byte and,
+  * 		if it answers, runs the software reset and HD44780_Restore_Display(). A missing display
+  * 		costs one probe per interval, so the caller's latency doesn't depend on the display's health.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Check_Health(HD44780_HandleTypeDef *Display_Handle)
+{
+	if (!Display_Handle->Needs_Reinit || ((HAL_GetTick() - Display_Handle->Error_Tick) < HD44780_REINIT_INTERVAL_MS)) {
+		return;
+	}
+
+	Display_Handle->Error_Tick = HAL_GetTick();
+	if (!Display_Handle->Transport->Probe(Display_Handle, 1, HD44780_I2C_TIMEOUT_MS)) {
+		return;
+	} /* Still gone */
+
+#if (HD44780_USE_ASYNC == 1)
+	Display_Handle->Async_Enabled = false; /* Error callback already dropped the queue */
+#endif
+	const uint8_t Display_Control = Display_Handle->Display_Control;
+	Display_Handle->Needs_Reinit = false;
+	Display_Handle->State = HD44780_READY;
+	HD44780_Software_Reset(Display_Handle);
+	HD44780_Write_Register(Display_Handle, &Display_Handle->Display_Control, Display_Control); /* Cursor, blink and display off, if changed since init */
+	HD44780_Restore_Display(Display_Handle);
+#if (HD44780_USE_ASYNC == 1)
+	Display_Handle->Async_Enabled = (Display_Handle->Transport == &HD44780_Transport_I2C);
+#endif
+}
+
+/**
+  * @brief 	Executes when a transfer keeps failing or the busy flag times out, Display_Handle->State
+  * 		says which. Up to user on how to handle (log, raise an alarm, ...) but must return: the
+  * 		driver keeps running without the display and re-initializes it on its own. Also called
+  * 		from the I2C error interrupt when HD44780_USE_ASYNC is 1.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Error_Handler(HD44780_HandleTypeDef *Display_Handle)
+{
+	/* USER CODE BEGIN */
+	(void)Display_Handle;
+	/* USER CODE END */
+}
+
+/**
+  * @brief 	Updates the current cursor position in Display_Handle->CursorPosition from the software model of
+  * 		the address counter. Nothing is read from the LCD, see HD44780_Verify_Cursor_Position() for that.
+  * 		Inverse of HD44780_Get_Address(): in 2-line mode rows 0/1 start at 0x00/0x40 and rows 2/3
+  * 		continue those lines after Cols characters. See HD44780 pgs. 10-12.
+  * @param 	Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  */
+static void HD44780_Get_Cursor_Position(HD44780_HandleTypeDef *Display_Handle)
+{
+	const uint8_t AddressCopy = Display_Handle->AddressCounter;
+
+	if (Display_Handle->Rows == 1) {
+		Display_Handle->Cursor_Position[0] = 0;
+		Display_Handle->Cursor_Position[1] = AddressCopy;
+		return;
+	} /* 1-line mode, one 80 character line */
+
+	const uint8_t Line = (AddressCopy >= 0x40) ? 1 : 0;
+	const uint8_t LineOffset = (uint8_t)(AddressCopy & 0x3F);
+	uint8_t row = (uint8_t)(Line + (2 * (LineOffset / Display_Handle->Cols)));
+	uint8_t column = (uint8_t)(LineOffset % Display_Handle->Cols);
+
+	if (row >= Display_Handle->Rows) {
+		row = (uint8_t)(Display_Handle->Rows - 2 + Line);
+		column = (uint8_t)(AddressCopy - Display_Handle->Row_Offsets[row]);
+	} /* Past the last visible character of a line */
+
+	Display_Handle->Cursor_Position[0] = row;
+	Display_Handle->Cursor_Position[1] = column;
+}
+
+/**
+  * @brief 	Returns the DDRAM address of a cell using the row offset table built by HD44780_Init_Display().
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Row index (0-indexed).
+  * @param 	Column index (0-indexed).
+  * @retval DDRAM address.
+  */
+static uint8_t HD44780_Get_Address(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column)
+{
+	return (uint8_t)(Display_Handle->Row_Offsets[row] + column);
+}
+
+/**
+  * @brief 	Checks if the busy flag/address counter can be read back right now. Not the case in timed
+  * 		execution mode (write-only backpacks) or while the transmit queue owns the bus.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @retval True if HD44780_Check_Status() may be used.
+  */
+static bool HD44780_Uses_Busy_Flag(HD44780_HandleTypeDef *Display_Handle)
+{
+#if (HD44780_USE_ASYNC == 1)
+	if (Display_Handle->Async_Enabled) {
+		return false;
+	}
+#endif
+
+	return (Display_Handle->Exec_Mode != HD44780_EXEC_TIMED);
+} /* Write-only transports are kept in timed execution */
+
+/**
+  * @brief 	Clears text stored in Display_Handle->Text.
+  * @param 	Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  */
+static void Clear_Text_Buffer(HD44780_HandleTypeDef *Display_Handle)
+{
+#if (HD44780_USE_SHADOW == 1)
+	memset(Display_Handle->Text, '\0', (Display_Handle->Rows * Display_Handle->Cols));
+#endif
+	Display_Handle->Stale_Rows = 0;
+}
+
+
+#if (HD44780_USE_SHADOW == 1)
+/**
+  * @brief 	Compares a character shown on the display with the one wanted in the back buffer.
+  * 		NULL and space both render as a blank cell, so they are treated as equal.
+  * @param 	Character in Display_Handle->Text.
+  * @param 	Character in Display_Handle->Back_Buffer.
+  * @retval True if no DDRAM write is needed for this cell.
+  */
+static bool HD44780_Cell_Matches(char Shown, char Wanted)
+{
+	if (Shown == '\0') {
+		Shown = ' ';
+	}
+
+	if (Wanted == '\0') {
+		Wanted = ' ';
+	}
+
+	return (Shown == Wanted);
+}
+#endif
+
+/**
+  * @brief 	DDRAM address the HD44780 moves to after writing a character at Address (auto-increment).
+  * 		1-line mode wraps after 80 characters, 2-line mode after 40 per line. See HD44780 pg. 11.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Current DDRAM address.
+  * @retval Next DDRAM address.
+  */
+static uint8_t HD44780_Next_Address(HD44780_HandleTypeDef *Display_Handle, uint8_t Address)
+{
+	Address++;
+	if (Display_Handle->Rows == 1) {
+		if (Address == 0x50) {
+			Address = 0x00;
+		}
+	}
+
+	else if (Address == 0x28) {
+		Address = 0x40;
+	}
+
+	else if (Address == 0x68) {
+		Address = 0x00;
+	}
+
+	return Address;
+}
+
+#if (HD44780_USE_ARENA == 1)
+/**
+  * @brief 	Points Text and the frames of a handle at Cells characters each, taken from the static arena.
+  * 		A handle initialized again keeps its storage while it is big enough, so retrying
+  * 		HD44780_Init_Display() doesn't drain the pool. Storage is never given back.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Rows * Cols of the display.
+  * @retval False if the arena or the owner table is full.
+  */
+static bool HD44780_Arena_Take(HD44780_HandleTypeDef *Display_Handle, uint16_t Cells)
+{
+	const uint16_t Length = (uint16_t)(Cells * HD44780_BUFFERS_PER_DISPLAY);
+	uint8_t Owner = HD44780_MAX_DISPLAYS;
+
+	for (uint8_t i = 0; i < HD44780_MAX_DISPLAYS; i++) {
+		if ((Arena_Owner[i] == Display_Handle) || ((Arena_Owner[i] == NULL) && (Owner == HD44780_MAX_DISPLAYS))) {
+			Owner = i;
+		}
+	} /* Own entry first, else the first free one */
+
+	if (Owner == HD44780_MAX_DISPLAYS) {
+		return false;
+	}
+
+	if ((Arena_Owner[Owner] != Display_Handle) || (Arena_Length[Owner] < Length)) {
+		if (Length > (HD44780_ARENA_SIZE - HD44780_Arena_Used)) {
+			return false;
+		}
+
+		Arena_Owner[Owner] = Display_Handle;
+		Arena_Storage[Owner] = &HD44780_Arena[HD44780_Arena_Used];
+		Arena_Length[Owner] = Length;
+		HD44780_Arena_Used = (uint16_t)(HD44780_Arena_Used + Length);
+	} /* A bigger display on the same handle takes fresh storage, the old block is lost */
+
+	char *Storage = Arena_Storage[Owner];
+#if (HD44780_USE_SHADOW == 1)
+	Display_Handle->Text = Storage;
+	Storage += Cells;
+#endif
+#if (HD44780_FRAME_BUFFERS > 0)
+	for (uint8_t i = 0; i < HD44780_FRAME_BUFFERS; i++) {
+		Display_Handle->Frame[i] = Storage;
+		Storage += Cells;
+	}
+#endif
+	(void)Storage;
+
+	return true;
+}
+#endif
+
+#if (HD44780_FRAME_BUFFERS > 0)
+/**
+  * @brief 	Adds one instruction to a flush plan: its transfer (port bytes + transport overhead) and the wait
+  * 		HD44780_Wait_Execution() will do after it in the handle's current execution mode.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Plan being built.
+  * @param 	Port bytes of the instruction (HD44780_COMMAND_FRAME_LEN or HD44780_DATA_FRAME_LEN).
+  * @param 	Execution time of the instruction.
+  */
+static void HD44780_Add_Cost(HD44780_HandleTypeDef *Display_Handle, HD44780_CostTypeDef *Cost, uint8_t PortBytes, uint32_t ExecutionTime_us)
+{
+	const HD44780_TransportTypeDef *Transport = Display_Handle->Transport;
+	const uint32_t Poll_Bytes = (HD44780_POLL_PORT_BYTES + (HD44780_POLL_TRANSFERS * Transport->Overhead_Bytes));
+	uint32_t Bytes = (PortBytes + Transport->Overhead_Bytes);
+	uint32_t Wait_us = 0;
+
+	if (HD44780_Uses_Busy_Flag(Display_Handle)) {
+		const uint32_t Poll_us = (Poll_Bytes * Transport->Byte_Time_us);
+		if (Display_Handle->Exec_Mode == HD44780_EXEC_TIMED_VERIFY) {
+			Wait_us = ExecutionTime_us;
+			Bytes += Poll_Bytes;
+		} /* Waits it out, then a single check */
+
+		else {
+			Bytes += (Poll_Bytes * (1 + (ExecutionTime_us / Poll_us)));
+		} /* Polls until done */
+	}
+
+	else if (ExecutionTime_us > Transport->Leadin_us) {
+		Wait_us = ExecutionTime_us;
+	} /* Otherwise covered by the next transfer */
+
+	Cost->Bus_Bytes += Bytes;
+	Cost->Time_us += ((Bytes * Transport->Byte_Time_us) + Wait_us);
+	Cost->Instructions++;
+}
+
+/**
+  * @brief 	Adds one character write to a flush plan. With the transmit queue, consecutive writes are
+  * 		appended to the frame queued before them (HD44780_QUEUE_FRAME_CHARS per frame) and only
+  * 		cost their 4 nibble bytes, the first write of a run pays for its own transfer. Blocking
+  * 		writes without busy flag reads skip the RS setup byte after the first one of a run.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Plan being built.
+  * @param 	Position of the character in its run of consecutive writes, 0 = after a jump.
+  */
+static void HD44780_Add_Data_Cost(HD44780_HandleTypeDef *Display_Handle, HD44780_CostTypeDef *Cost, uint8_t RunIndex)
+{
+	bool Setup = ((RunIndex == 0) || HD44780_Uses_Busy_Flag(Display_Handle)); /* Status reads leave RS LOW */
+
+#if (HD44780_USE_ASYNC == 1)
+	if (Display_Handle->Async_Enabled && ((RunIndex % HD44780_QUEUE_FRAME_CHARS) != 0)) {
+		Cost->Bus_Bytes += (HD44780_DATA_FRAME_LEN - 1);
+		Cost->Time_us += ((HD44780_DATA_FRAME_LEN - 1) * Display_Handle->Transport->Byte_Time_us);
+		Cost->Instructions++;
+		return;
+	} /* No address or RS setup byte */
+
+	Setup |= Display_Handle->Async_Enabled; /* Every queued frame has its own */
+#endif
+
+	HD44780_Add_Cost(Display_Handle, Cost, (Setup ? HD44780_DATA_FRAME_LEN : (HD44780_DATA_FRAME_LEN - 1)), Display_Handle->Exec_Time_us);
+}
+
+/**
+  * @brief 	Checks whether rewriting Gap unchanged cells between two changed runs is cheaper than
+  * 		ending the run and jumping over them with a set DDRAM address instruction. Compares the
+  * 		gap plus the next changed cell against the jump plus that cell starting a new run.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Number of unchanged cells.
+  * @param 	Position of the first gap cell in the current run.
+  * @retval True if the runs should be merged.
+  */
+static bool HD44780_Bridge_Gap(HD44780_HandleTypeDef *Display_Handle, uint8_t Gap, uint8_t RunIndex)
+{
+	HD44780_CostTypeDef Rewrite = {0};
+	HD44780_CostTypeDef Jump = {0};
+
+	for (uint8_t i = 0; i <= Gap; i++) {
+		HD44780_Add_Data_Cost(Display_Handle, &Rewrite, (uint8_t)(RunIndex + i));
+	}
+	HD44780_Add_Cost(Display_Handle, &Jump, HD44780_COMMAND_FRAME_LEN, Display_Handle->Exec_Time_us);
+	HD44780_Add_Data_Cost(Display_Handle, &Jump, 0);
+
+	return (Rewrite.Time_us <= Jump.Time_us);
+}
+
+/**
+  * @brief 	Sends, or only costs, the changed runs of Frame for rows FirstRow up to (not including)
+  * 		LastRow. A run starts with a set DDRAM address unless the address counter is already
+  * 		there, and swallows short gaps of unchanged cells when HD44780_Bridge_Gap() says so.
+  * 		Planning and sending walk the same code, so HD44780_Flush_Cost() matches HD44780_Flush().
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Frame to show, Display_Handle->Flush_Frame when sending.
+  * @param 	First row to bring up to date.
+  * @param 	Row after the last one to bring up to date.
+  * @param 	Cleared. True plans against a blank display (after clear display) instead of Text.
+  * @param 	Plan. NULL sends to the display, otherwise only adds the cost of the flush.
+  */
+static void HD44780_Flush_Rows(HD44780_HandleTypeDef *Display_Handle, const char *Frame, uint8_t FirstRow, uint8_t LastRow, bool Cleared, HD44780_CostTypeDef *Plan)
+{
+	uint8_t Address = Cleared ? 0x00 : Display_Handle->AddressCounter;
+
+	if (Plan == NULL) {
+		HD44780_Glyph_Upload(Display_Handle); /* Before any cell that shows them */
+	}
+
+	for (uint8_t row = FirstRow; row < LastRow; row++) {
+		const uint16_t RowStart = (row * Display_Handle->Cols);
+		const bool Stale = (!Cleared && (Display_Handle->Stale_Rows & (1 << row)));
+		bool Changed[HD44780_MAX_COLS];
+
+		for (uint8_t column = 0; column < Display_Handle->Cols; column++) {
+			const char Shown = Cleared ? '\0' : Display_Handle->Text[RowStart + column];
+			Changed[column] = (Stale || !HD44780_Cell_Matches(Shown, Frame[RowStart + column]));
+		}
+
+		uint8_t column = 0;
+		while (column < Display_Handle->Cols) {
+			if (!Changed[column]) {
+				column++;
+				continue;
+			}
+
+			/* Start of a changed run, jump once then rely on auto-increment */
+			if (Address != HD44780_Get_Address(Display_Handle, row, column)) {
+				if (Plan != NULL) {
+					HD44780_Add_Cost(Display_Handle, Plan, HD44780_COMMAND_FRAME_LEN, Display_Handle->Exec_Time_us);
+				}
+
+				else {
+					HD44780_Set_Cursor_Position(Display_Handle, row, column);
+				}
+				Address = HD44780_Get_Address(Display_Handle, row, column);
+			}
+
+			uint8_t RunEnd = column;
+			while (RunEnd < Display_Handle->Cols) {
+				if (Changed[RunEnd]) {
+					RunEnd++;
+					continue;
+				}
+
+				uint8_t Gap = 0;
+				while (((RunEnd + Gap) < Display_Handle->Cols) && !Changed[RunEnd + Gap]) {
+					Gap++;
+				}
+				if (((RunEnd + Gap) == Display_Handle->Cols) || !HD44780_Bridge_Gap(Display_Handle, Gap, (uint8_t)(RunEnd - column))) {
+					break;
+				} /* Nothing left to reach in this row, or cheaper to jump */
+				RunEnd = (uint8_t)(RunEnd + Gap);
+			}
+
+			for (uint8_t RunIndex = 0; column < RunEnd; column++, RunIndex++) {
+				const char Wanted = Frame[RowStart + column];
+				if (Plan != NULL) {
+					HD44780_Add_Data_Cost(Display_Handle, Plan, RunIndex);
+				}
+
+				else {
+					HD44780_Send_Data(Display_Handle, (uint8_t)((Wanted == '\0') ? ' ' : Wanted), true);
+					Display_Handle->Text[RowStart + column] = Wanted;
+				}
+				Address = HD44780_Next_Address(Display_Handle, Address);
+			}
+
+			if (Plan == NULL) {
+				Display_Handle->Cursor_Position[0] = row;
+				Display_Handle->Cursor_Position[1] = column;
+			}
+		}
+
+		if (Plan == NULL) {
+			Display_Handle->Stale_Rows &= (uint8_t)~(1 << row);
+		}
+	}
+}
+
+/**
+  * @brief 	Picks the cheaper of two ways to bring the whole display up to date: the incremental
+  * 		update, or clear display followed by every non-blank cell of the back buffer. Pending
+  * 		glyph uploads cost the same either way. Clearing is not an option while the rows are
+  * 		scrolled with the display shift, clear display would reset it.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Frame to show.
+  * @param 	Receives the cheaper plan.
+  */
+static void HD44780_Plan_Flush(HD44780_HandleTypeDef *Display_Handle, const char *Frame, HD44780_CostTypeDef *Cost)
+{
+	HD44780_CostTypeDef Incremental = {0};
+	HD44780_CostTypeDef Cleared = {0};
+
+	for (uint8_t Slot = 0; Slot < HD44780_GLYPH_SLOTS; Slot++) {
+		if (Display_Handle->Glyph_Pending & (1 << Slot)) {
+			HD44780_Add_Cost(Display_Handle, &Incremental, HD44780_COMMAND_FRAME_LEN, Display_Handle->Exec_Time_us);
+			for (uint8_t Line = 0; Line < 8; Line++) {
+				HD44780_Add_Data_Cost(Display_Handle, &Incremental, Line);
+			}
+		}
+	}
+	if (Display_Handle->Glyph_Pending != 0) {
+		HD44780_Add_Cost(Display_Handle, &Incremental, HD44780_COMMAND_FRAME_LEN, Display_Handle->Exec_Time_us);
+	} /* Back to DDRAM */
+	Cleared = Incremental;
+
+	HD44780_Flush_Rows(Display_Handle, Frame, 0, Display_Handle->Rows, false, &Incremental);
+
+	if (!Display_Handle->Scroll_Hardware) {
+		HD44780_Add_Cost(Display_Handle, &Cleared, HD44780_COMMAND_FRAME_LEN, Display_Handle->Clear_Time_us);
+		HD44780_Flush_Rows(Display_Handle, Frame, 0, Display_Handle->Rows, true, &Cleared);
+		Cleared.Clear = true;
+
+		if (Cleared.Time_us < Incremental.Time_us) {
+			*Cost = Cleared;
+			return;
+		}
+	}
+
+	*Cost = Incremental;
+}
+
+/**
+  * @brief 	Hands the last published frame to the flush engine by exchanging Ready_Frame and
+  * 		Flush_Frame with interrupts masked, so a HD44780_Swap() from an interrupt or another task
+  * 		lands either before or after, never in the middle of what is being sent.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @retval True if a new frame was taken.
+  */
+static bool HD44780_Take_Frame(HD44780_HandleTypeDef *Display_Handle)
+{
+	const uint32_t PriMask = __get_PRIMASK();
+	__disable_irq();
+
+	const bool Taken = Display_Handle->Frame_Ready;
+	if (Taken) {
+		char *Frame = Display_Handle->Flush_Frame;
+		Display_Handle->Flush_Frame = Display_Handle->Ready_Frame;
+		Display_Handle->Ready_Frame = Frame;
+		Display_Handle->Frame_Ready = false;
+	}
+
+	__set_PRIMASK(PriMask);
+	return Taken;
+}
+
+/**
+  * @brief 	Brings the display up to date with Display_Handle->Flush_Frame, clearing first when the
+  * 		plan says that is cheaper. Only the flush engine writes the snapshot, so every run comes
+  * 		from the same frame.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Send_Frame(HD44780_HandleTypeDef *Display_Handle)
+{
+	HD44780_CostTypeDef Plan;
+	HD44780_Plan_Flush(Display_Handle, Display_Handle->Flush_Frame, &Plan);
+	if (Plan.Clear) {
+		HD44780_Send_Command(Display_Handle, 0x01, true);
+		Clear_Text_Buffer(Display_Handle);
+		Display_Handle->Cursor_Position[0] = 0;
+		Display_Handle->Cursor_Position[1] = 0;
+	} /* Cheaper than the incremental update, Text is blank now */
+
+	HD44780_Flush_Rows(Display_Handle, Display_Handle->Flush_Frame, 0, Display_Handle->Rows, false, NULL);
+}
+
+/**
+  * @brief 	Writes a cell owned by the driver itself (scrolled rows, posted cells) into every frame,
+  * 		so neither a later swap nor the frame being sent puts the old character back.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Cell index (row * Cols + column).
+  * @param 	Character.
+  */
+static void HD44780_Frame_Set_All(HD44780_HandleTypeDef *Display_Handle, uint16_t Index, char Character)
+{
+	for (uint8_t i = 0; i < HD44780_FRAME_BUFFERS; i++) {
+		Display_Handle->Frame[i][Index] = Character;
+	}
+}
+
+/**
+  * @brief 	Number of positions a software scrolled row cycles through: the string plus
+  * 		HD44780_SCROLL_GAP blanks, at least one full row so short strings wrap around the display.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Row index (0-indexed).
+  */
+static uint16_t HD44780_Scroll_Period_Length(HD44780_HandleTypeDef *Display_Handle, uint8_t row)
+{
+	const uint16_t Length = (Display_Handle->Scroll[row].Length + HD44780_SCROLL_GAP);
+
+	return (Length > Display_Handle->Cols) ? Length : Display_Handle->Cols;
+}
+
+/**
+  * @brief 	Renders the visible window of a software scrolled row into every frame and sends
+  * 		the cells that changed.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Row index (0-indexed).
+  */
+static void HD44780_Scroll_Render(HD44780_HandleTypeDef *Display_Handle, uint8_t row)
+{
+	const HD44780_ScrollTypeDef *Scroll = &Display_Handle->Scroll[row];
+	const uint16_t Period = HD44780_Scroll_Period_Length(Display_Handle, row);
+
+	for (uint8_t column = 0; column < Display_Handle->Cols; column++) {
+		const uint16_t Index = ((Scroll->Offset + column) % Period);
+		HD44780_Frame_Set_All(Display_Handle, (uint16_t)((row * Display_Handle->Cols) + column), ((Index < Scroll->Length) ? Scroll->Text[Index] : ' '));
+	}
+
+	HD44780_Flush_Rows(Display_Handle, Display_Handle->Flush_Frame, row, (uint8_t)(row + 1), false, NULL);
+}
+
+/**
+  * @brief 	Picks how the scrolling rows are moved. The display shift instruction moves every row by
+  * 		one position for a single command frame, a software window resends about one frame per
+  * 		visible character, so the shift is used whenever it gives the same picture: all rows
+  * 		scroll the same way at the same speed and every string fits a DDRAM line (pg. 11).
+  * 		Switching to the shift loads each string into its DDRAM line once, padded with blanks.
+  * 		Switching back undoes the shift with return home.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Scroll_Select(HD44780_HandleTypeDef *Display_Handle)
+{
+	const HD44780_ScrollTypeDef *First = &Display_Handle->Scroll[0];
+	const uint8_t LineLength = HD44780_LINE_LEN(Display_Handle->Rows);
+	bool Hardware = (Display_Handle->Rows <= 2);
+
+	HD44780_Canvas_Release(Display_Handle);
+
+	for (uint8_t row = 0; row < Display_Handle->Rows; row++) {
+		const HD44780_ScrollTypeDef *Scroll = &Display_Handle->Scroll[row];
+		if ((Scroll->Text == NULL) | (Scroll->Length > LineLength)
+				| (Scroll->Direction != First->Direction) | (Scroll->Period_ms != First->Period_ms)) {
+			Hardware = false;
+		}
+	}
+
+	if (Hardware && !Display_Handle->Scroll_Hardware) {
+		for (uint8_t row = 0; row < Display_Handle->Rows; row++) {
+			HD44780_ScrollTypeDef *Scroll = &Display_Handle->Scroll[row];
+			HD44780_Send_Command(Display_Handle, (0x80 | Display_Handle->Row_Offsets[row]), HD44780_Uses_Busy_Flag(Display_Handle));
+			for (uint8_t i = 0; i < LineLength; i++) {
+				const char Character = (i < Scroll->Length) ? Scroll->Text[i] : ' ';
+				HD44780_Send_Data(Display_Handle, (uint8_t)Character, HD44780_Uses_Busy_Flag(Display_Handle));
+				if (i < Display_Handle->Cols) {
+					Display_Handle->Text[(row * Display_Handle->Cols) + i] = Character;
+					HD44780_Frame_Set_All(Display_Handle, (uint16_t)((row * Display_Handle->Cols) + i), Character);
+				}
+			}
+			Scroll->Offset = 0;
+		}
+
+		HD44780_Get_Cursor_Position(Display_Handle);
+		Display_Handle->Scroll_Hardware = true;
+	}
+
+	else if (!Hardware && Display_Handle->Scroll_Hardware) {
+		if (Display_Handle->Scroll_Shift != 0) {
+			HD44780_Send_Command(Display_Handle, 0x02, HD44780_Uses_Busy_Flag(Display_Handle));
+			Display_Handle->Cursor_Position[0] = 0;
+			Display_Handle->Cursor_Position[1] = 0;
+			Display_Handle->Scroll_Shift = 0;
+		}
+		Display_Handle->Scroll_Hardware = false;
+	}
+
+	if (!Display_Handle->Scroll_Hardware) {
+		for (uint8_t row = 0; row < Display_Handle->Rows; row++) {
+			if (Display_Handle->Scroll[row].Text != NULL) {
+				HD44780_Scroll_Render(Display_Handle, row);
+			}
+		}
+	}
+}
+
+/**
+  * @brief 	Moves every scrolling row whose period has elapsed by one position. Falls behind by at
+  * 		most one step instead of catching up in a burst when HD44780_Process() is called late.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Scroll_Tick(HD44780_HandleTypeDef *Display_Handle)
+{
+	const uint32_t Now = HAL_GetTick();
+	bool Stopped = false;
+
+	if (Display_Handle->Scroll_Paused) {
+		return;
+	}
+
+	for (uint8_t row = 0; row < Display_Handle->Rows; row++) {
+		HD44780_ScrollTypeDef *Scroll = &Display_Handle->Scroll[row];
+		const uint32_t Elapsed = (Now - Scroll->Last_Tick);
+
+		if ((Scroll->Text == NULL) | (Elapsed < Scroll->Period_ms)) {
+			continue;
+		}
+
+		Scroll->Last_Tick = (Elapsed >= (2UL * Scroll->Period_ms)) ? Now : (Scroll->Last_Tick + Scroll->Period_ms);
+
+		if (Display_Handle->Scroll_Hardware) {
+			const uint8_t LineLength = HD44780_LINE_LEN(Display_Handle->Rows);
+			const bool Left = (Scroll->Direction == HD44780_SCROLL_LEFT);
+			if (row == 0) {
+				HD44780_Send_Command(Display_Handle, (Left ? HD44780_SHIFT_LEFT : HD44780_SHIFT_RIGHT), HD44780_Uses_Busy_Flag(Display_Handle));
+				Display_Handle->Scroll_Shift = (uint8_t)((Display_Handle->Scroll_Shift + (Left ? 1 : (LineLength - 1))) % LineLength);
+			} /* One shift moves every row */
+			else {
+				Scroll->Last_Tick = Display_Handle->Scroll[0].Last_Tick;
+			}
+			Scroll->Offset = Display_Handle->Scroll_Shift; /* Picks up from here if the rows fall back to software */
+		}
+
+		else {
+			const uint16_t Period = HD44780_Scroll_Period_Length(Display_Handle, row);
+			Scroll->Offset = (uint16_t)((Scroll->Direction == HD44780_SCROLL_LEFT) ? ((Scroll->Offset + 1) % Period)
+					: ((Scroll->Offset + Period - 1) % Period));
+			HD44780_Scroll_Render(Display_Handle, row);
+		}
+
+		if ((Scroll->Steps != 0) && (--Scroll->Steps == 0)) {
+			Scroll->Text = NULL;
+			Stopped = true;
+		}
+	}
+
+	if (Stopped) {
+		HD44780_Scroll_Select(Display_Handle);
+	}
+}
+
+/**
+  * @brief 	Brings the scroll engine in line with a clear display or return home from the user. Both
+  * 		undo the display shift (pg. 24), so rows moved by it are back at their first position:
+  * 		after return home they start again from there, after clear display, which erased them,
+  * 		they are stopped. Software scrolled rows redraw themselves on their next step. A canvas
+  * 		held in DDRAM is let go, its view put back on the columns loaded at DDRAM column 0.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	True for clear display.
+  */
+static void HD44780_Scroll_Home(HD44780_HandleTypeDef *Display_Handle, bool Cleared)
+{
+	bool Scrolling = false;
+
+	if (!Display_Handle->Scroll_Hardware) {
+		return;
+	}
+
+	Display_Handle->Scroll_Shift = 0;
+	Display_Handle->Scroll_Hardware = false;
+
+	if (Display_Handle->Canvas != NULL) {
+		Display_Handle->Canvas->View_Column = Display_Handle->Canvas_Column;
+		Display_Handle->Canvas = NULL;
+		Display_Handle->Canvas_Column = 0;
+	} /* The next HD44780_Canvas_View() loads it again */
+
+	for (uint8_t row = 0; row < Display_Handle->Rows; row++) {
+		HD44780_ScrollTypeDef *Scroll = &Display_Handle->Scroll[row];
+		if ((Scroll->Text != NULL) && Cleared) {
+			Scroll->Text = NULL;
+		}
+
+		else if (Scroll->Text != NULL) {
+			Scroll->Offset = 0;
+			Scrolling = true;
+		}
+	}
+
+	if (Scrolling) {
+		HD44780_Scroll_Select(Display_Handle);
+	} /* Picks the shift again, reloading the lines it moves */
+}
+
+/**
+  * @brief 	Loads the canvas rows shown now into their DDRAM lines so the view can move with the
+  * 		display shift. The line is rotated to the current view: DDRAM column 0 keeps the cell
+  * 		that is already visible, so only the hidden part of the line and changed cells are written.
+  * 		Needs a canvas no wider than a DDRAM line and the shift at 0.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Canvas, View_Row and View_Column still at the picture currently shown.
+  */
+static void HD44780_Canvas_Load(HD44780_HandleTypeDef *Display_Handle, HD44780_CanvasTypeDef *Canvas)
+{
+	const uint8_t LineLength = HD44780_LINE_LEN(Display_Handle->Rows);
+
+	for (uint8_t row = 0; row < Display_Handle->Rows; row++) {
+		for (uint8_t i = 0; i < LineLength; i++) {
+			const char Character = HD44780_Canvas_Cell(Canvas, (uint16_t)(Canvas->View_Row + row), (uint16_t)((Canvas->View_Column + i) % LineLength));
+			const uint8_t Address = (uint8_t)(Display_Handle->Row_Offsets[row] + i);
+
+			if (i < Display_Handle->Cols) {
+				const uint16_t Index = (uint16_t)((row * Display_Handle->Cols) + i);
+				HD44780_Frame_Set_All(Display_Handle, Index, Character);
+				if (HD44780_Cell_Matches(Display_Handle->Text[Index], Character)) {
+					continue;
+				} /* Already on the display */
+				Display_Handle->Text[Index] = Character;
+			}
+
+			if (Display_Handle->AddressCounter != Address) {
+				HD44780_Send_Command(Display_Handle, (0x80 | Address), HD44780_Uses_Busy_Flag(Display_Handle));
+			}
+			HD44780_Send_Data(Display_Handle, (uint8_t)Character, HD44780_Uses_Busy_Flag(Display_Handle));
+		}
+	}
+
+	HD44780_Get_Cursor_Position(Display_Handle);
+	Display_Handle->Scroll_Hardware = true;
+	Display_Handle->Canvas = Canvas;
+	Display_Handle->Canvas_Column = Canvas->View_Column;
+	Canvas->Dirty = false;
+}
+
+/**
+  * @brief 	Stops moving the canvas with the display shift. Return home undoes the shift, which
+  * 		shows the columns loaded at DDRAM column 0 again, the ones Text was left with.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Canvas_Release(HD44780_HandleTypeDef *Display_Handle)
+{
+	if (Display_Handle->Canvas == NULL) {
+		return;
+	}
+
+	if (Display_Handle->Scroll_Shift != 0) {
+		HD44780_Send_Command(Display_Handle, 0x02, HD44780_Uses_Busy_Flag(Display_Handle));
+		Display_Handle->Cursor_Position[0] = 0;
+		Display_Handle->Cursor_Position[1] = 0;
+		Display_Handle->Scroll_Shift = 0;
+	}
+
+	Display_Handle->Canvas->View_Column = Display_Handle->Canvas_Column;
+	Display_Handle->Scroll_Hardware = false;
+	Display_Handle->Canvas = NULL;
+}
+
+/**
+  * @brief 	Shifts the display until the canvas held in DDRAM shows column in the leftmost column,
+  * 		going whichever way round the line takes fewer shift commands.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Canvas column wanted in the leftmost column.
+  */
+static void HD44780_Canvas_Shift(HD44780_HandleTypeDef *Display_Handle, uint16_t column)
+{
+	const uint8_t LineLength = HD44780_LINE_LEN(Display_Handle->Rows);
+	const uint8_t Target = (uint8_t)((column + LineLength - Display_Handle->Canvas_Column) % LineLength);
+	const uint8_t Left = (uint8_t)((Target + LineLength - Display_Handle->Scroll_Shift) % LineLength);
+	const bool ShiftLeft = (Left <= (LineLength - Left));
+
+	for (uint8_t Steps = ShiftLeft ? Left : (uint8_t)(LineLength - Left); Steps > 0; Steps--) {
+		HD44780_Send_Command(Display_Handle, (ShiftLeft ? HD44780_SHIFT_LEFT : HD44780_SHIFT_RIGHT), HD44780_Uses_Busy_Flag(Display_Handle));
+		Display_Handle->Scroll_Shift = (uint8_t)((Display_Handle->Scroll_Shift + (ShiftLeft ? 1 : (LineLength - 1))) % LineLength);
+	}
+}
+
+/**
+  * @brief 	Reads one canvas cell, blank outside the canvas.
+  * @param 	Canvas.
+  * @param 	Canvas row.
+  * @param 	Canvas column.
+  * @retval Character at row/column.
+  */
+static char HD44780_Canvas_Cell(const HD44780_CanvasTypeDef *Canvas, uint16_t row, uint16_t column)
+{
+	if ((row >= Canvas->Rows) | (column >= Canvas->Width)) {
+		return ' ';
+	}
+
+	return Canvas->Buffer[((uint32_t)row * Canvas->Width) + column];
+}
+
+
+#endif /* HD44780_FRAME_BUFFERS */
+
+/**
+  * @brief 	Checks whether a CGRAM slot is shown on the display or waiting in the back buffer.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	CGRAM slot (0-7).
+  * @retval True if the slot's pattern must not be replaced.
+  */
+static bool HD44780_Glyph_On_Screen(HD44780_HandleTypeDef *Display_Handle, uint8_t Slot)
+{
+#if (HD44780_USE_SHADOW == 1)
+	const char Code = (char)HD44780_GLYPH_CODE(Slot);
+	const uint16_t NumElements = (Display_Handle->Rows * Display_Handle->Cols);
+
+	for (uint16_t i = 0; i < NumElements; i++) {
+		if (Display_Handle->Text[i] == Code) {
+			return true;
+		} /* Shown */
+#if (HD44780_FRAME_BUFFERS > 0)
+		if ((Display_Handle->Back_Buffer[i] == Code) | (Display_Handle->Flush_Frame[i] == Code)
+				| (Display_Handle->Frame_Ready && (Display_Handle->Ready_Frame[i] == Code))) {
+			return true;
+		} /* Being sent, drawn, or published and not taken yet */
+#endif
+	}
+
+	return false;
+#else
+	(void)Display_Handle;
+	(void)Slot;
+	return true; /* Nothing tells what DDRAM shows, an assigned slot is never replaced */
+#endif
+}
+
+/**
+  * @brief 	Writes the patterns of all pending slots into CGRAM, 9 instructions per glyph
+  * 		(set CGRAM address + 8 lines), then points the address counter back at DDRAM where it was.
+  * 		See HD44780 pg. 19 Table 5 and pg. 29.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Glyph_Upload(HD44780_HandleTypeDef *Display_Handle)
+{
+	if (Display_Handle->Glyph_Pending == 0) {
+		return;
+	}
+
+	const uint8_t Address = Display_Handle->AddressCounter;
+	for (uint8_t Slot = 0; Slot < HD44780_GLYPH_SLOTS; Slot++) {
+		if (Display_Handle->Glyph_Pending & (1 << Slot)) {
+			HD44780_Send_Command(Display_Handle, (0x40 | (Slot << 3)), HD44780_Uses_Busy_Flag(Display_Handle));
+			for (uint8_t Line = 0; Line < 8; Line++) {
+				HD44780_Send_Data(Display_Handle, (Display_Handle->Glyph_Slot[Slot]->Lines[Line] & 0x1F), HD44780_Uses_Busy_Flag(Display_Handle));
+			}
+		}
+	}
+	Display_Handle->Glyph_Pending = 0;
+
+	HD44780_Send_Command(Display_Handle, (0x80 | Address), HD44780_Uses_Busy_Flag(Display_Handle)); /* Back to DDRAM */
+}
+
+#if (HD44780_FRAME_BUFFERS > 0)
+/**
+  * @brief 	Converts a number into ASCII digits, least significant first. With Decimals, a point is
+  * 		put after that many digits and the integer part keeps at least one digit ("0.5").
+  * @param 	Buffer receiving the digits, at least HD44780_DIGITS_LEN characters.
+  * @param 	Magnitude of the number.
+  * @param 	Base, 10 or 16.
+  * @param 	Digits after the point, 0 = integer.
+  * @param 	'A' or 'a', first letter used for hex digits.
+  * @retval Number of characters written.
+  */
+static uint8_t HD44780_Format_Digits(char *Digits, uint32_t Value, uint8_t Base, uint8_t Decimals, char Alpha)
+{
+	uint8_t Length = 0;
+
+	do {
+		if ((Decimals != 0) && (Length == Decimals)) {
+			Digits[Length++] = '.';
+		}
+
+		const uint8_t Digit = (uint8_t)(Value % Base);
+		Digits[Length++] = (char)((Digit < 10) ? ('0' + Digit) : (Alpha + Digit - 10));
+		Value /= Base;
+	} while ((Value != 0) || (Length <= Decimals));
+
+	return Length;
+}
+
+/**
+  * @brief 	Writes digits from HD44780_Format_Digits() into the back buffer with sign and padding.
+  * 		Zero padding goes between the sign and the digits, space padding before the sign.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Back buffer index of the next cell, advanced past the number.
+  * @param 	Back buffer index the number must not reach.
+  * @param 	Digits, least significant first.
+  * @param 	Number of digits.
+  * @param 	Negative. Adds a '-' sign.
+  * @param 	Minimum width including the sign.
+  * @param 	'0' or ' '.
+  * @param 	Left. Pads on the right instead (always with spaces).
+  */
+static void HD44780_Frame_Number(HD44780_HandleTypeDef *Display_Handle, uint16_t *Index, uint16_t End, const char *Digits, uint8_t Length, bool Negative, uint8_t Width, char Pad, bool Left)
+{
+	const uint8_t Used = (uint8_t)(Length + (Negative ? 1 : 0));
+	uint8_t Padding = (Width > Used) ? (uint8_t)(Width - Used) : 0;
+
+	if (!Left && (Pad == ' ')) {
+		for (; (Padding > 0) && (*Index < End); Padding--) {
+			Display_Handle->Back_Buffer[(*Index)++] = ' ';
+		}
+	}
+
+	if (Negative && (*Index < End)) {
+		Display_Handle->Back_Buffer[(*Index)++] = '-';
+	}
+
+	if (!Left) {
+		for (; (Padding > 0) && (*Index < End); Padding--) {
+			Display_Handle->Back_Buffer[(*Index)++] = '0';
+		}
+	}
+
+	while ((Length > 0) && (*Index < End)) {
+		Display_Handle->Back_Buffer[(*Index)++] = Digits[--Length];
+	}
+
+	for (; (Padding > 0) && (*Index < End); Padding--) {
+		Display_Handle->Back_Buffer[(*Index)++] = ' ';
+	}
+}
+#endif /* HD44780_FRAME_BUFFERS */
+
+#if (HD44780_POST_DEPTH > 0)
+/**
+  * @brief 	Draws the writes posted so far. Each entry is taken out of the ring with interrupts masked
+  * 		for a few instructions, the bus is only used with interrupts enabled. Cells already showing
+  * 		the character are skipped, the address counter goes back to the cursor afterwards so
+  * 		HD44780_Print() continues where it left off.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Post_Drain(HD44780_HandleTypeDef *Display_Handle)
+{
+	bool Written = false;
+
+	for (uint8_t n = 0; n < HD44780_POST_DEPTH; n++) {
+		const uint32_t PriMask = __get_PRIMASK();
+		__disable_irq();
+		if (Display_Handle->Post_Count == 0) {
+			__set_PRIMASK(PriMask);
+			break;
+		}
+
+		const HD44780_PostTypeDef Post = Display_Handle->Post[Display_Handle->Post_Tail];
+		const uint16_t Index = ((Post.Row * Display_Handle->Cols) + Post.Column);
+#if (HD44780_POST_OVERFLOW == HD44780_POST_COALESCE)
+		Display_Handle->Post_Slot[Index] = 0;
+#endif
+		Display_Handle->Post_Tail = (uint8_t)((Display_Handle->Post_Tail + 1) % HD44780_POST_DEPTH);
+		Display_Handle->Post_Count--;
+		__set_PRIMASK(PriMask);
+
+#if (HD44780_FRAME_BUFFERS > 0)
+		HD44780_Frame_Set_All(Display_Handle, Index, Post.Character); /* Kept by later flushes */
+#endif
+		if (HD44780_Cell_Matches(Display_Handle->Text[Index], Post.Character) && !(Display_Handle->Stale_Rows & (1 << Post.Row))) {
+			continue;
+		}
+
+		const uint8_t Address = HD44780_Get_Address(Display_Handle, Post.Row, Post.Column);
+		if (Display_Handle->AddressCounter != Address) {
+			HD44780_Send_Command(Display_Handle, (0x80 | Address), HD44780_Uses_Busy_Flag(Display_Handle));
+		}
+		HD44780_Send_Data(Display_Handle, (uint8_t)Post.Character, HD44780_Uses_Busy_Flag(Display_Handle));
+		Display_Handle->Text[Index] = Post.Character;
+		Written = true;
+	}
+
+	const uint8_t Cursor = HD44780_Get_Address(Display_Handle, Display_Handle->Cursor_Position[0], Display_Handle->Cursor_Position[1]);
+	if (Written && (Display_Handle->AddressCounter != Cursor)) {
+		HD44780_Send_Command(Display_Handle, (0x80 | Cursor), HD44780_Uses_Busy_Flag(Display_Handle));
+	}
+}
+#endif
+
+/* ####################### Transport Backends #################### */
+/**
+  * @brief 	Probes the PCF8574 with its address byte.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Number of address probes.
+  * @param 	Timeout per probe.
+  * @retval True if the PCF8574 acknowledged.
+  */
+static bool HD44780_I2C_Probe(HD44780_HandleTypeDef *Display_Handle, uint32_t Trials, uint32_t Timeout_ms)
+{
+	return (HAL_I2C_IsDeviceReady(Display_Handle->HW061_I2C_Handle, Display_Handle->I2C_Address, Trials, Timeout_ms) == HAL_OK);
+}
+
+/**
+  * @brief 	Sends port bytes to the PCF8574 in one I2C transaction. Each byte takes ~90us at 100kHz.
+  * 		A bus held busy by a stuck slave is recovered before HD44780_Write_Burst() retries.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Port bytes to send.
+  * @param 	Number of port bytes.
+  * @retval HAL status of the transfer.
+  */
+static HAL_StatusTypeDef HD44780_I2C_Write(HD44780_HandleTypeDef *Display_Handle, const uint8_t *PortBytes, uint16_t Length)
+{
+	const HAL_StatusTypeDef Status = HAL_I2C_Master_Transmit(Display_Handle->HW061_I2C_Handle, Display_Handle->I2C_Address, (uint8_t *)PortBytes, Length, HD44780_I2C_TIMEOUT_MS);
+	if (Status == HAL_BUSY) {
+		HD44780_Bus_Recovery(Display_Handle);
+	} /* SDA held low */
+
+	return Status;
+}
+
+/**
+  * @brief 	Reads the PCF8574 port in one I2C transaction. See PCF8574 pg. 9.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Receives the port byte (P7..P0).
+  * @retval HAL status of the transfer.
+  */
+static HAL_StatusTypeDef HD44780_I2C_Read(HD44780_HandleTypeDef *Display_Handle, uint8_t *PortByte)
+{
+	const HAL_StatusTypeDef Status = HAL_I2C_Master_Receive(Display_Handle->HW061_I2C_Handle, Display_Handle->I2C_Address, PortByte, 1, HD44780_I2C_TIMEOUT_MS);
+	if (Status == HAL_BUSY) {
+		HD44780_Bus_Recovery(Display_Handle);
+	}
+
+	return Status;
+}
+
+/**
+  * @brief 	Can_Read of transports that always have a read path.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @retval True.
+  */
+static bool HD44780_Always(HD44780_HandleTypeDef *Display_Handle)
+{
+	(void)Display_Handle;
+	return true;
+}
+
+/**
+  * @brief 	A parallel bus can't tell if the display is there, HD44780_Check_Status() times out instead.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Unused.
+  * @param 	Unused.
+  * @retval True.
+  */
+static bool HD44780_GPIO_Probe(HD44780_HandleTypeDef *Display_Handle, uint32_t Trials, uint32_t Timeout_ms)
+{
+	(void)Display_Handle;
+	(void)Trials;
+	(void)Timeout_ms;
+	return true;
+}
+
+/**
+  * @brief 	Drives the port bits onto the HD44780 pins, one BSRR write per port byte so RS, RW, the
+  * 		data bits and EN change together. Each byte is held for HD44780_GPIO_PULSE_US, which covers
+  * 		the EN pulse width and the data setup/hold times (HD44780 pg. 49/52).
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Port bytes to send.
+  * @param 	Number of port bytes.
+  * @retval HAL_OK.
+  */
+static HAL_StatusTypeDef HD44780_GPIO_Write(HD44780_HandleTypeDef *Display_Handle, const uint8_t *PortBytes, uint16_t Length)
+{
+	const HD44780_GPIO_ConfigTypeDef *Config = (const HD44780_GPIO_ConfigTypeDef *)Display_Handle->Transport_Config;
+
+	for (uint16_t i = 0; i < Length; i++) {
+		uint32_t Set = 0;
+		uint32_t Reset = 0;
+		for (uint8_t Bit = 0; Bit < 8; Bit++) {
+			if (PortBytes[i] & (1 << Bit)) {
+				Set |= Config->Pin[Bit];
+			}
+
+			else {
+				Reset |= Config->Pin[Bit];
+			}
+		} /* Pins left at 0 drop out of both masks */
+
+		Config->Port->BSRR = (Set | (Reset << 16));
+		HD44780_Delay_us(HD44780_GPIO_PULSE_US);
+	}
+
+	return HAL_OK;
+}
+
+/**
+  * @brief 	Samples D4..D7 while EN is HIGH. The data pins were released (set HIGH, open drain) by
+  * 		the port byte that raised EN, so the HD44780 is driving them.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Receives the data nibble in bits 7..4.
+  * @retval HAL_ERROR if RW isn't connected.
+  */
+static HAL_StatusTypeDef HD44780_GPIO_Read(HD44780_HandleTypeDef *Display_Handle, uint8_t *PortByte)
+{
+	const HD44780_GPIO_ConfigTypeDef *Config = (const HD44780_GPIO_ConfigTypeDef *)Display_Handle->Transport_Config;
+	const uint32_t Input = Config->Port->IDR;
+
+	if (Config->Pin[1] == 0) {
+		return HAL_ERROR;
+	}
+
+	*PortByte = 0;
+	for (uint8_t Bit = 4; Bit < 8; Bit++) {
+		if (Input & Config->Pin[Bit]) {
+			*PortByte |= (1 << Bit);
+		}
+	}
+	return HAL_OK;
+}
+
+/**
+  * @brief 	The busy flag can only be read with RW wired to a GPIO.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @retval True if RW is connected.
+  */
+static bool HD44780_GPIO_Can_Read(HD44780_HandleTypeDef *Display_Handle)
+{
+	return (((const HD44780_GPIO_ConfigTypeDef *)Display_Handle->Transport_Config)->Pin[1] != 0);
+}
+
+#if defined(HAL_SPI_MODULE_ENABLED)
+/**
+  * @brief 	Shifts each port byte into the 74HC595 and latches it onto Q0..Q7 with an RCLK pulse, so
+  * 		the outputs change together like a PCF8574 port write. See 74HC595 datasheet, Figure 7.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Port bytes to send.
+  * @param 	Number of port bytes.
+  * @retval HAL status of the first failed SPI transfer, HAL_OK otherwise.
+  */
+static HAL_StatusTypeDef HD44780_HC595_Write(HD44780_HandleTypeDef *Display_Handle, const uint8_t *PortBytes, uint16_t Length)
+{
+	const HD44780_HC595_ConfigTypeDef *Config = (const HD44780_HC595_ConfigTypeDef *)Display_Handle->Transport_Config;
+
+	for (uint16_t i = 0; i < Length; i++) {
+		const HAL_StatusTypeDef Status = HAL_SPI_Transmit(Config->SPI_Handle, (uint8_t *)&PortBytes[i], 1, HD44780_HC595_TIMEOUT_MS);
+		if (Status != HAL_OK) {
+			return Status;
+		}
+
+		Config->Latch_Port->BSRR = Config->Latch_Pin;
+		Config->Latch_Port->BSRR = ((uint32_t)Config->Latch_Pin << 16);
+		HD44780_Delay_us(HD44780_GPIO_PULSE_US);
+	} /* Latch pulse, then hold the byte */
+
+	return HAL_OK;
+}
+
+/**
+  * @brief 	The 74HC595 is write-only, RW is tied low.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Unused.
+  * @retval HAL_ERROR.
+  */
+static HAL_StatusTypeDef HD44780_HC595_Read(HD44780_HandleTypeDef *Display_Handle, uint8_t *PortByte)
+{
+	(void)Display_Handle;
+	(void)PortByte;
+	return HAL_ERROR;
+}
+
+/**
+  * @brief 	Can_Read of write-only transports.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @retval False.
+  */
+static bool HD44780_Never(HD44780_HandleTypeDef *Display_Handle)
+{
+	(void)Display_Handle;
+	return false;
+}
+#endif
+
+const HD44780_TransportTypeDef HD44780_Transport_I2C = {
+	.Probe = HD44780_I2C_Probe,
+	.Write = HD44780_I2C_Write,
+	.Read = HD44780_I2C_Read,
+	.Can_Read = HD44780_Always,
+	.Byte_Time_us = HD44780_BYTE_TIME_US,
+	.Leadin_us = HD44780_FRAME_LEADIN_US,
+	.Overhead_Bytes = 1
+};
+
+const HD44780_TransportTypeDef HD44780_Transport_GPIO = {
+	.Probe = HD44780_GPIO_Probe,
+	.Write = HD44780_GPIO_Write,
+	.Read = HD44780_GPIO_Read,
+	.Can_Read = HD44780_GPIO_Can_Read,
+	.Byte_Time_us = HD44780_GPIO_PULSE_US,
+	.Leadin_us = 0,
+	.Overhead_Bytes = 0
+};
+
+#if defined(HAL_SPI_MODULE_ENABLED)
+const HD44780_TransportTypeDef HD44780_Transport_HC595 = {
+	.Probe = HD44780_GPIO_Probe,        /* Write-only as well, nothing to probe */
+	.Write = HD44780_HC595_Write,
+	.Read = HD44780_HC595_Read,
+	.Can_Read = HD44780_Never,
+	.Byte_Time_us = (HD44780_GPIO_PULSE_US + 2), /* HAL_SPI_Transmit() call and latch pulse */
+	.Leadin_us = 0,
+	.Overhead_Bytes = 0
+};
+#endif
+
+/* ########################## Public Functions ########################### */
+/**
+  * @brief  Meant for end user. Initializes HD44780 through software reset using the address and
+  * 		geometry in HW061_I2C_ADDR, HD44780_NUM_ROWS and HD44780_NUM_COLS.
+  * 		See HD44780 pg. 46, Figure 24 for initialization sequence.
+  * @param  Pointer to HAL I2C_HandleTypeDef
+  * @param  Pointer to HD44780_HandleTypeDef struct.
+  * @retval Boolean indicating if initialization was successful.
+  */
+bool HD44780_Init(I2C_HandleTypeDef *I2C_Handle, HD44780_HandleTypeDef *Display_Handle)
+{
+	return HD44780_Init_Display(I2C_Handle, Display_Handle, HW061_I2C_ADDR, HD44780_NUM_ROWS, HD44780_NUM_COLS);
+}
+
+/**
+  * @brief  Meant for end user. Initializes one of several HD44780 displays, each with its own PCF8574
+  * 		address and geometry. Several handles may share the same I2C bus. With HD44780_WARM_RESTART
+  * 		a controller that kept its setup over an MCU reset is only reconfigured, skipping the
+  * 		power on wait and the software reset. See HD44780 pg. 46, Figure 24 for initialization sequence.
+  * @param  Pointer to HAL I2C_HandleTypeDef
+  * @param  Pointer to HD44780_HandleTypeDef struct.
+  * @param  PCF8574 address, shifted left by one (PCF8574 pg. 13).
+  * @param  Number of rows, at most HD44780_MAX_ROWS.
+  * @param  Number of columns, at most HD44780_MAX_COLS.
+  * @retval Boolean indicating if initialization was successful.
+  */
+bool HD44780_Init_Display(I2C_HandleTypeDef *I2C_Handle, HD44780_HandleTypeDef *Display_Handle, uint16_t Address, uint8_t Rows, uint8_t Cols)
+{
+	Display_Handle->HW061_I2C_Handle = I2C_Handle;
+	Display_Handle->I2C_Address = Address;
+	return HD44780_Init_Transport(Display_Handle, &HD44780_Transport_I2C, NULL, Rows, Cols);
+}
+
+/**
+  * @brief  Meant for end user. Initializes a display wired through any transport backend:
+  * 		HD44780_Transport_I2C (what HD44780_Init_Display() uses, fill in HW061_I2C_Handle and
+  * 		I2C_Address first), HD44780_Transport_GPIO or HD44780_Transport_HC595. The pins and
+  * 		peripherals must already be configured. Transports that can't read put the display in
+  * 		HD44780_EXEC_TIMED and always do the full software reset. The transmit queue only runs
+  * 		on HD44780_Transport_I2C, other transports block like HD44780_USE_ASYNC 0.
+  * @param  Pointer to HD44780_HandleTypeDef struct.
+  * @param  Transport backend.
+  * @param  Backend configuration (HD44780_GPIO_ConfigTypeDef, ...), must stay valid. NULL for I2C.
+  * @param  Number of rows, at most HD44780_MAX_ROWS.
+  * @param  Number of columns, at most HD44780_MAX_COLS.
+  * @retval Boolean indicating if initialization was successful.
+  */
+bool HD44780_Init_Transport(HD44780_HandleTypeDef *Display_Handle, const HD44780_TransportTypeDef *Transport, const void *Config, uint8_t Rows, uint8_t Cols)
+{
+	if ((Rows == 0) | (Rows > HD44780_MAX_ROWS) | (Cols == 0) | (Cols > HD44780_MAX_COLS)) {
+		return false;
+	} /* Doesn't fit Display_Handle->Text */
+
+#if (HD44780_USE_ARENA == 1)
+	if (!HD44780_Arena_Take(Display_Handle, (uint16_t)(Rows * Cols))) {
+		return false;
+	} /* HD44780_ARENA_SIZE too small for this display */
+#endif
+
+	Display_Handle->Transport = Transport;
+	Display_Handle->Transport_Config = Config;
+	if (Transport->Probe(Display_Handle, HD44780_READY_TRIALS, HD44780_READY_TIMEOUT_MS)) {
+		HD44780_Delay_Init();
+		Display_Handle->Rows = Rows;
+		Display_Handle->Cols = Cols;
+		for (uint8_t row = 0; row < Rows; row++) {
+			Display_Handle->Row_Offsets[row] = (Rows == 1) ? 0x00 : HD44780_ROW_OFFSET(row, Cols);
+		}
+#if (HD44780_USE_ASYNC == 1)
+		Display_Handle->Async_Enabled = false; /* Software reset needs the busy flag */
+		Display_Handle->Queue_Head = 0;
+		Display_Handle->Queue_Tail = 0;
+		Display_Handle->Queue_Count = 0;
+		Display_Handle->Queue_Active = false;
+		Display_Handle->Queue_Waiting = false;
+#endif
+		Display_Handle->Cursor_Position[0] = 0;
+		Display_Handle->Cursor_Position[1] = 0;
+		Display_Handle->AddressCounter = 0;
+		Display_Handle->Print_Count = 0;
+		Display_Handle->Port_Byte = 0xFF; /* PCF8574 power on state (PCF8574 pg. 1) */
+		Display_Handle->Backlight = HD44780_BACKLIGHT;
+		Display_Handle->State = HD44780_READY;
+		Display_Handle->Needs_Reinit = false;
+		Display_Handle->Error_Tick = 0;
+		HD44780_Set_Execution_Mode(Display_Handle, HD44780_DEFAULT_EXEC_MODE);
+		Display_Handle->Wait_Mode = HD44780_DEFAULT_WAIT_MODE;
+		Display_Handle->Exec_Time_us = HD44780_T_EXEC_US;
+		Display_Handle->Clear_Time_us = HD44780_T_CLEAR_US;
+		Clear_Text_Buffer(Display_Handle);
+#if (HD44780_FRAME_BUFFERS > 0)
+		for (uint8_t i = 0; i < HD44780_FRAME_BUFFERS; i++) {
+			memset(Display_Handle->Frame[i], '\0', (Rows * Cols));
+		}
+		Display_Handle->Back_Buffer = Display_Handle->Frame[0];
+		Display_Handle->Ready_Frame = Display_Handle->Frame[HD44780_FRAME_BUFFERS / 2];
+		Display_Handle->Flush_Frame = Display_Handle->Frame[HD44780_FRAME_BUFFERS - 1]; /* All three are one buffer with HD44780_FRAME_BUFFERS 1 */
+		Display_Handle->Frame_Ready = false;
+		memset(Display_Handle->Scroll, 0, sizeof(Display_Handle->Scroll));
+		Display_Handle->Scroll_Hardware = false;
+		Display_Handle->Scroll_Paused = false;
+		Display_Handle->Scroll_Shift = 0;
+		Display_Handle->Canvas = NULL;
+		Display_Handle->Canvas_Column = 0;
+#endif
+		memset(Display_Handle->Glyph_Slot, 0, sizeof(Display_Handle->Glyph_Slot)); /* CGRAM content is undefined after power on */
+		memset(Display_Handle->Glyph_Used, 0, sizeof(Display_Handle->Glyph_Used));
+		Display_Handle->Glyph_Clock = 0;
+		Display_Handle->Glyph_Pending = 0;
+		Display_Handle->Scrub_Row = 0;
+		Display_Handle->Scrub_Tick = HAL_GetTick();
+#if (HD44780_POST_DEPTH > 0)
+		Display_Handle->Post_Head = 0;
+		Display_Handle->Post_Tail = 0;
+		Display_Handle->Post_Count = 0;
+		Display_Handle->Post_Dropped = 0;
+#if (HD44780_POST_OVERFLOW == HD44780_POST_COALESCE)
+		memset(Display_Handle->Post_Slot, 0, sizeof(Display_Handle->Post_Slot));
+#endif
+#endif
+#if (HD44780_USE_STATS == 1)
+		memset(&Display_Handle->Stats, 0, sizeof(Display_Handle->Stats));
+#endif
+#if (HD44780_TRACE_DEPTH > 0)
+		Display_Handle->Trace_Head = 0;
+		Display_Handle->Trace_Count = 0;
+#endif
+
+#if (HD44780_WARM_RESTART == 1)
+		if (HD44780_Probe_Warm(Display_Handle)) {
+			HD44780_Warm_Restart(Display_Handle);
+		}
+
+		else if (!Display_Handle->Needs_Reinit) {
+			HD44780_Delay_ms(HD44780_T_POWER_ON_MS); /* May have just been powered on */
+			HD44780_Software_Reset(Display_Handle);
+		}
+#else
+		HD44780_Delay_ms(HD44780_T_POWER_ON_MS);
+		HD44780_Software_Reset(Display_Handle);
+#endif
+
+#if (HD44780_CALIBRATE_AT_INIT == 1)
+		if (!Display_Handle->Needs_Reinit) {
+			HD44780_Calibrate(Display_Handle);
+		} /* Keeps the datasheet timing if the module can't be read */
+#endif
+
+		Display_Handle->PowerState = LCD1602_ON; /* Display and cursor on, left by both init paths */
+
+#if (HD44780_USE_ASYNC == 1)
+		if (Transport == &HD44780_Transport_I2C) {
+			HD44780_Register_Handle(Display_Handle);
+			Display_Handle->Async_Enabled = true;
+		}
+#endif
+		return !Display_Handle->Needs_Reinit;
+	}
+
+	else {
+		return false;
+	} /* No established connection with the display */
+}
+
+/**
+  * @brief Meant for end-user. Sends pre-defined commands to HD44780.
+  * 		Cursor, blink and display on/off are independent bits of the shadowed display control
+  * 		register, a command that wouldn't change it (or the backlight) sends nothing.
+  * @param Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param UserCommand from enum HD44780_User_Command_List (CLEAR_DISPLAY, RETURN_HOME, ...)
+  */
+HD44780_State HD44780_Transmit_Command(HD44780_HandleTypeDef *Display_Handle, HD44780_User_Command_List UserCommand)
+{
+	HD44780_Check_Health(Display_Handle);
+
+	if (Display_Handle->PowerState == LCD1602_ON) {
+		switch(UserCommand) {
+			case CLEAR_DISPLAY:
+				HD44780_Send_Fixed(Display_Handle, CLEAR_DISPLAY);
+				Clear_Text_Buffer(Display_Handle);
+				Display_Handle->Cursor_Position[0] = 0;
+				Display_Handle->Cursor_Position[1] = 0;
+#if (HD44780_FRAME_BUFFERS > 0)
+				HD44780_Scroll_Home(Display_Handle, true);
+#endif
+				break;
+
+			case RETURN_HOME:
+				HD44780_Send_Fixed(Display_Handle, RETURN_HOME);
+				Display_Handle->Cursor_Position[0] = 0;
+				Display_Handle->Cursor_Position[1] = 0;
+#if (HD44780_FRAME_BUFFERS > 0)
+				HD44780_Scroll_Home(Display_Handle, false);
+#endif
+				break;
+
+			case DISPLAY_OFF:
+				HD44780_Write_Register(Display_Handle, &Display_Handle->Display_Control, (Display_Handle->Display_Control & ~HD44780_DISPLAY_BIT));
+				Display_Handle->PowerState = LCD1602_OFF;
+				break;
+
+			case CURSOR_ON:
+				HD44780_Write_Register(Display_Handle, &Display_Handle->Display_Control, (Display_Handle->Display_Control | HD44780_CURSOR_BIT));
+				break;
+
+			case CURSOR_OFF:
+				HD44780_Write_Register(Display_Handle, &Display_Handle->Display_Control, (Display_Handle->Display_Control & ~HD44780_CURSOR_BIT));
+				break;
+
+			case CURSOR_BLINK:
+				HD44780_Write_Register(Display_Handle, &Display_Handle->Display_Control, (Display_Handle->Display_Control | HD44780_BLINK_BIT));
+				break;
+
+			case CURSOR_UNBLINK:
+				HD44780_Write_Register(Display_Handle, &Display_Handle->Display_Control, (Display_Handle->Display_Control & ~HD44780_BLINK_BIT));
+				break;
+
+			case BACKLIGHT_ON:
+				HD44780_Set_Backlight(Display_Handle, HD44780_BACKLIGHT);
+				break;
+
+			case BACKLIGHT_OFF:
+				HD44780_Set_Backlight(Display_Handle, 0);
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	else if (Display_Handle->PowerState == LCD1602_OFF) {
+		switch (UserCommand) {
+			case DISPLAY_ON:
+				HD44780_Write_Register(Display_Handle, &Display_Handle->Display_Control, (Display_Handle->Display_Control | HD44780_DISPLAY_BIT));
+				Display_Handle->PowerState = LCD1602_ON;
+				break;
+
+			case BACKLIGHT_ON:
+				HD44780_Set_Backlight(Display_Handle, HD44780_BACKLIGHT);
+				break;
+
+			case BACKLIGHT_OFF:
+				HD44780_Set_Backlight(Display_Handle, 0);
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	return Display_Handle->State;
+}
+
+/**
+  * @brief 	Meant for end-user. Prints text to the LCD starting at current
+  * 		cursor position. Automatically goes to new row when there's no more display
+  * 		room on the 1st row. Stops printing and sets cursor to (0,0) if there's no more
+  * 		display room. Moving to the next row is a single set DDRAM address command computed
+  * 		from the row offset table, skipped when auto-increment already lands there (40 column displays).
+  * @param 	Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param 	String to print.
+  */
+HD44780_State HD44780_Print(HD44780_HandleTypeDef *Display_Handle, const char *str)
+{
+	HD44780_Check_Health(Display_Handle);
+	HD44780_Glyph_Upload(Display_Handle);
+	HD44780_Get_Cursor_Position(Display_Handle);
+	uint8_t row = Display_Handle->Cursor_Position[0];
+	uint8_t column = Display_Handle->Cursor_Position[1];
+	uint8_t startindex = ((row * Display_Handle->Cols) + column);; /*Find index where text ends in Display_Handle->Text */
+
+	for (uint16_t i = 0; str[i] != '\0'; i++) {
+		if ((startindex + i) > ((Display_Handle->Rows * Display_Handle->Cols) - 1)) { /* No more display room */
+			HD44780_Set_Cursor_Position(Display_Handle, 0, 0);
+			return Display_Handle->State;
+		}
+
+		HD44780_Send_Data(Display_Handle, (uint8_t)str[i], true); /* Updates AddressCounter automatically */
+#if (HD44780_USE_SHADOW == 1)
+		Display_Handle->Text[startindex + i] = str[i];
+#endif
+		column++;
+
+		if ((column == Display_Handle->Cols) && ((row + 1) < Display_Handle->Rows)) { /* end of row, go to next row */
+			row++;
+			column = 0;
+			if (Display_Handle->AddressCounter != HD44780_Get_Address(Display_Handle, row, 0)) {
+				HD44780_Set_Cursor_Position(Display_Handle, row, 0);
+			}
+		}
+	}
+	Display_Handle->Cursor_Position[0] = row; /* Update cursor position at end */
+	Display_Handle->Cursor_Position[1] = column;
+
+#if (HD44780_CURSOR_CHECK_INTERVAL > 0)
+	if (++Display_Handle->Print_Count >= HD44780_CURSOR_CHECK_INTERVAL) {
+		Display_Handle->Print_Count = 0;
+		HD44780_Verify_Cursor_Position(Display_Handle);
+	} /* Periodic consistency check against the hardware */
+#endif
+
+	return Display_Handle->State;
+}
+
+/**
+  * @brief  Meant for end-user. Sets the cursor position WILL NOT WORK IF
+  * 		DISPLAY IS LEFT OR RIGHT SHIFTED AT ANY POINT.
+  * @param 	Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param 	Row index (0-indexed).
+  * @param 	Column index (0-indexed).
+  */
+HD44780_State HD44780_Set_Cursor_Position(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column)
+{
+	HD44780_Check_Health(Display_Handle);
+
+	uint8_t Command;
+	if ((row >= Display_Handle->Rows) | (column >= Display_Handle->Cols)) {
+		return Display_Handle->State;
+	}
+
+	else{
+		Command = (0x80 | HD44780_Get_Address(Display_Handle, row, column));
+		HD44780_Send_Command(Display_Handle, Command, true);
+		Display_Handle->Cursor_Position[0] = row;
+		Display_Handle->Cursor_Position[1] = column;
+	}
+
+	return Display_Handle->State;
+}
+
+/**
+  * @brief  Meant for front-ends that resolve the geometry at compile time (HD44780.hpp). Sends a set
+  * 		DDRAM address instruction already expanded with HD44780_NIBBLE_STREAM(..., HD44780_BACKLIGHT),
+  * 		typically a constant in flash. No range check and no encoding, the address is trusted.
+  * 		With the backlight off the instruction is encoded again like HD44780_Transmit_Command().
+  * @param 	Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param 	HD44780_COMMAND_FRAME_LEN port bytes of (0x80 | address).
+  */
+HD44780_State HD44780_Transmit_Address(HD44780_HandleTypeDef *Display_Handle, const uint8_t *Stream)
+{
+	const uint8_t Command = (uint8_t)((Stream[0] & 0xF0) | (Stream[2] >> 4));
+
+	HD44780_Check_Health(Display_Handle);
+
+	if (Display_Handle->Backlight != HD44780_BACKLIGHT) {
+		HD44780_Send_Command(Display_Handle, Command, true);
+	}
+
+	else {
+		HD44780_Send_Stream(Display_Handle, Command, Stream, true);
+	}
+	HD44780_Get_Cursor_Position(Display_Handle);
+
+	return Display_Handle->State;
+}
+
+/**
+  * @brief  Meant for end-user. Retrieves the character on LCD display at specified coordinates.
+  * 		Answered from Text; with HD44780_USE_SHADOW 0 the cell is read back from DDRAM, 0 if it can't be.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Row coordinate.
+  * @param	Column coordinate.
+  * @retval Character at specified coordinate.
+  */
+char HD44780_Read_Character(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column)
+{
+	if ((row >= Display_Handle->Rows) | (column >= Display_Handle->Cols)) {
+		return 0;
+	}
+
+	else {
+#if (HD44780_USE_SHADOW == 1)
+		uint8_t index = ((row * Display_Handle->Cols) + column);
+		return (Display_Handle->Text[index]);
+#else
+		char Character[1] = { 0 };
+		const uint8_t Resume = Display_Handle->AddressCounter;
+		if (HD44780_Uses_Busy_Flag(Display_Handle) && !Display_Handle->Needs_Reinit) {
+			HD44780_Read_Data(Display_Handle, HD44780_Get_Address(Display_Handle, row, column), Character, 1);
+			if (Display_Handle->AddressCounter != Resume) {
+				HD44780_Send_Command(Display_Handle, (0x80 | Resume), true);
+			}
+		} /* No shadow, ask DDRAM */
+		return Character[0];
+#endif
+	}
+
+}
+
+/**
+  * @brief  Meant for end-user. Retrieves the current row number the cursor is on.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @retval Current row (0-indexed).
+  */
+uint8_t HD44780_Get_Row_Index(HD44780_HandleTypeDef *Display_Handle)
+{
+	return Display_Handle->Cursor_Position[0];
+}
+
+/**
+  * @brief  Meant for end-user. Retrieves the current column number the cursor is on.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @retval Current column (0-indexed).
+  */
+uint8_t HD44780_Get_Column_Index(HD44780_HandleTypeDef *Display_Handle)
+{
+	return Display_Handle->Cursor_Position[1];
+}
+
+/**
+  * @brief  Meant for end-user. Reads the address counter back from the LCD and compares it with the
+  * 		software model the driver keeps while sending. On a mismatch the hardware value wins and
+  * 		the cursor position is updated. Does nothing if the busy flag can't be read (timed
+  * 		execution mode or transmit queue enabled).
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @retval False if the software model was out of sync.
+  */
+bool HD44780_Verify_Cursor_Position(HD44780_HandleTypeDef *Display_Handle)
+{
+	if (!HD44780_Uses_Busy_Flag(Display_Handle) || Display_Handle->Needs_Reinit) {
+		return true;
+	}
+
+	const uint8_t Expected = Display_Handle->AddressCounter;
+	HD44780_Wait_Execution(Display_Handle, 0, true); /* Polls until the busy flag clears, updates AddressCounter */
+	HD44780_Get_Cursor_Position(Display_Handle);
+	return (Display_Handle->AddressCounter == Expected);
+}
+
+/**
+  * @brief  Meant for end-user. Reads a whole row back from DDRAM, what the glass really shows, where
+  * 		HD44780_Read_Character() only returns the Text shadow. Needs the busy flag read path
+  * 		(not HD44780_EXEC_TIMED, transmit queue not enabled). The cursor is left where it was.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Row index (0-indexed).
+  * @param	Receives Cols characters, not terminated.
+  * @retval False if the row is off the display, the display can't be read or a transfer failed.
+  */
+bool HD44780_Read_Row(HD44780_HandleTypeDef *Display_Handle, uint8_t row, char *Buffer)
+{
+	HD44780_Check_Health(Display_Handle);
+
+	const uint8_t Resume = Display_Handle->AddressCounter;
+
+	if ((row >= Display_Handle->Rows) || !HD44780_Uses_Busy_Flag(Display_Handle) || Display_Handle->Needs_Reinit) {
+		return false;
+	}
+
+	const bool Read = HD44780_Read_Data(Display_Handle, HD44780_Get_Address(Display_Handle, row, 0), Buffer, Display_Handle->Cols);
+	if (Display_Handle->AddressCounter != Resume) {
+		HD44780_Send_Command(Display_Handle, (0x80 | Resume), true);
+	}
+
+	return Read && !Display_Handle->Needs_Reinit;
+}
+
+#if (HD44780_USE_SHADOW == 1)
+/**
+  * @brief  Meant for end-user. Reads the next row back from DDRAM and rewrites only the cells that
+  * 		don't match Text, e.g. after EMI on a long cable. Moves on one row per call, so each call
+  * 		costs one row of reads. Called by HD44780_Process() every HD44780_SCRUB_INTERVAL_MS.
+  * 		Rows Text doesn't know yet (warm restart) are left to HD44780_Flush().
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @retval Number of cells repaired.
+  */
+uint8_t HD44780_Scrub(HD44780_HandleTypeDef *Display_Handle)
+{
+	HD44780_Check_Health(Display_Handle);
+
+	const uint8_t row = Display_Handle->Scrub_Row;
+	const uint8_t Resume = Display_Handle->AddressCounter;
+	char Shown[HD44780_MAX_COLS];
+	uint8_t Repaired = 0;
+
+	Display_Handle->Scrub_Row = ((row + 1) < Display_Handle->Rows) ? (uint8_t)(row + 1) : 0;
+
+	if ((row >= Display_Handle->Rows) || (Display_Handle->Stale_Rows & (1 << row))
+			|| !HD44780_Uses_Busy_Flag(Display_Handle) || Display_Handle->Needs_Reinit) {
+		return 0;
+	}
+
+	if (!HD44780_Read_Data(Display_Handle, HD44780_Get_Address(Display_Handle, row, 0), Shown, Display_Handle->Cols)) {
+		return 0;
+	}
+
+	for (uint8_t column = 0; column < Display_Handle->Cols; column++) {
+		const char Shadow = Display_Handle->Text[(row * Display_Handle->Cols) + column];
+		const char Wanted = (Shadow == '\0') ? ' ' : Shadow; /* Blank cells hold a space in DDRAM */
+		if (Shown[column] == Wanted) {
+			continue;
+		}
+
+		if (Display_Handle->AddressCounter != HD44780_Get_Address(Display_Handle, row, column)) {
+			HD44780_Send_Command(Display_Handle, (0x80 | HD44780_Get_Address(Display_Handle, row, column)), true);
+		}
+		HD44780_Send_Data(Display_Handle, (uint8_t)Wanted, true);
+		Repaired++;
+	}
+
+	if (Display_Handle->AddressCounter != Resume) {
+		HD44780_Send_Command(Display_Handle, (0x80 | Resume), true);
+	}
+	HD44780_STAT_ADD(Display_Handle, Scrub_Repairs, Repaired);
+
+	return Repaired;
+}
+#endif
+
+/**
+  * @brief  Meant for end-user. Selects how the driver waits for an instruction to finish.
+  * 		HD44780_EXEC_BUSY_FLAG polls the busy flag, HD44780_EXEC_TIMED waits out the datasheet
+  * 		execution time and never reads (works with write-only backpacks), HD44780_EXEC_TIMED_VERIFY
+  * 		waits the execution time then checks the busy flag once, falling back to polling.
+  * 		Transports without a read path stay in HD44780_EXEC_TIMED.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Execution mode.
+  */
+void HD44780_Set_Execution_Mode(HD44780_HandleTypeDef *Display_Handle, HD44780_Exec_Mode Mode)
+{
+	Display_Handle->Exec_Mode = Display_Handle->Transport->Can_Read(Display_Handle) ? Mode : HD44780_EXEC_TIMED;
+}
+
+/**
+  * @brief  Meant for end-user. Selects how the driver spends its waits. HD44780_WAIT_SPIN busy-waits
+  * 		on the delay backend, HD44780_WAIT_SLEEP enters Sleep mode (WFI) during long instruction
+  * 		waits and while the transmit queue is full, woken by SysTick or the I2C/DMA interrupt.
+  * 		Display_Handle->Stats.Sleep_Time and Spin_Time show the split.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Wait mode.
+  */
+void HD44780_Set_Wait_Mode(HD44780_HandleTypeDef *Display_Handle, HD44780_Wait_Mode Mode)
+{
+	Display_Handle->Wait_Mode = Mode;
+}
+
+/**
+  * @brief  Meant for end-user. Measures how long this module keeps the busy flag set and replaces
+  * 		Display_Handle->Clear_Time_us and Exec_Time_us, so timed execution and the waits before a
+  * 		busy flag check run at the module's real speed instead of the datasheet worst case. Clones
+  * 		(KS0066, SPLC780) and RC oscillator spread make the difference. Over I2C a sample takes a few
+  * 		hundred us, far longer than a 37us instruction, so return home is timed instead: the first
+  * 		trial polls it to bound the execution time, the next HD44780_CALIBRATE_TRIALS - 1 each sample
+  * 		the middle of what is left. Both times come from the same oscillator (pg. 24 Table 6),
+  * 		Exec_Time_us is scaled from the result. HD44780_CALIBRATE_MARGIN_PCT is added to both.
+  * 		Takes about HD44780_CALIBRATE_TRIALS * 3ms. Called by HD44780_Init() with HD44780_CALIBRATE_AT_INIT.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @retval False if the module can't be read (write-only transport, transmit queue enabled), is
+  * 		shifted by the scroll engine, or answered too fast to measure. The timing is left as it was.
+  */
+bool HD44780_Calibrate(HD44780_HandleTypeDef *Display_Handle)
+{
+	HD44780_Check_Health(Display_Handle);
+
+	uint32_t Busy_us = 0;
+	uint32_t Ready_us = (HD44780_BUSY_TIMEOUT_MS * 1000U);
+	const uint8_t Resume = Display_Handle->AddressCounter;
+
+#if (HD44780_USE_ASYNC == 1)
+	if (Display_Handle->Async_Enabled) {
+		return false;
+	}
+#endif
+#if (HD44780_FRAME_BUFFERS > 0)
+	if (Display_Handle->Scroll_Shift != 0) {
+		return false;
+	} /* Return home would undo the display shift */
+#endif
+	if (!Display_Handle->Transport->Can_Read(Display_Handle) || Display_Handle->Needs_Reinit) {
+		return false;
+	}
+
+	const uint32_t Latency_us = HD44780_Calibrate_Trial(Display_Handle, 0, &Busy_us, &Ready_us); /* Earliest possible sample */
+	for (uint8_t Trial = 1; (Trial < HD44780_CALIBRATE_TRIALS) && ((Ready_us - Busy_us) > 1) && !Display_Handle->Needs_Reinit; Trial++) {
+		const uint32_t Target_us = ((Busy_us + Ready_us) / 2);
+		HD44780_Calibrate_Trial(Display_Handle, ((Target_us > Latency_us) ? (Target_us - Latency_us) : 0), &Busy_us, &Ready_us);
+	}
+
+	if (!Display_Handle->Needs_Reinit) {
+		HD44780_Send_Command(Display_Handle, (0x80 | Resume), true);
+	}
+
+	if (Display_Handle->Needs_Reinit || (Busy_us == 0) || (Ready_us >= (HD44780_BUSY_TIMEOUT_MS * 1000U))) {
+		return false;
+	} /* Failed, stuck, or ready at the first sample: nothing to scale from */
+
+	const uint32_t Clear_us = ((Ready_us * (100U + HD44780_CALIBRATE_MARGIN_PCT)) + 99U) / 100U;
+	const uint32_t Exec_us = ((HD44780_T_EXEC_US * Clear_us) + HD44780_T_CLEAR_US - 1U) / HD44780_T_CLEAR_US;
+	Display_Handle->Clear_Time_us = (uint16_t)((Clear_us > 0xFFFF) ? 0xFFFF : Clear_us);
+	Display_Handle->Exec_Time_us = (uint16_t)((Exec_us == 0) ? 1 : Exec_us);
+
+	return true;
+}
+
+/**
+  * @brief  Meant for end-user. Scrolls LCD text from left to right. See HD44780 pgs. 10-12 and 27.
+  * 		Blocks until every scroll is done, use HD44780_Scroll_Start() and HD44780_Process() to
+  * 		scroll without blocking. Resumes a paused scroll engine, and gives up after twice the
+  * 		nominal time or when the display is lost.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Number of times to scroll the text across the LCD.
+  */
+HD44780_State HD44780_Animate_Text(HD44780_HandleTypeDef *Display_Handle, uint8_t NumberOfScrolls)
+{
+	HD44780_Check_Health(Display_Handle);
+
+	bool TextPresent = (HD44780_USE_SHADOW == 0); /* Unknown without the shadow, shift anyway */
+#if (HD44780_USE_SHADOW == 1)
+	for (int i = 0; i < (Display_Handle->Rows * Display_Handle->Cols); i++) {
+		if (Display_Handle->Text[i] != 0){
+			TextPresent = true;
+			break;
+		}
+	}
+#endif
+
+	if (TextPresent && (NumberOfScrolls > 0)) {
+		const uint16_t NumberOfShifts = (uint16_t)(NumberOfScrolls * HD44780_LINE_LEN(Display_Handle->Rows));
+#if (HD44780_FRAME_BUFFERS > 0)
+		const uint32_t Limit_ms = (2UL * (NumberOfShifts + 1UL) * HD44780_ANIMATE_PERIOD_MS); /* Twice the nominal run */
+		const uint32_t Start = HAL_GetTick();
+
+		HD44780_Scroll_Pause(Display_Handle, false); /* A paused engine would never finish */
+		HD44780_Scroll_Start(Display_Handle, HD44780_ALL_ROWS, NULL, HD44780_SCROLL_RIGHT, HD44780_ANIMATE_PERIOD_MS);
+		for (uint8_t row = 0; row < Display_Handle->Rows; row++) {
+			Display_Handle->Scroll[row].Steps = NumberOfShifts;
+		}
+
+		while ((Display_Handle->Scroll[0].Text != NULL) && !Display_Handle->Needs_Reinit && ((HAL_GetTick() - Start) < Limit_ms)) {
+			HD44780_Process(Display_Handle);
+		}
+
+		if (Display_Handle->Scroll[0].Text != NULL) {
+			HD44780_Scroll_Stop(Display_Handle, HD44780_ALL_ROWS);
+		} /* Display lost or the steps stalled, don't leave the rows scrolling */
+#else
+		for (uint16_t i = 0; i < NumberOfShifts; i++) {
+			HD44780_Send_Command(Display_Handle, HD44780_SHIFT_RIGHT, true);
+			HD44780_Delay_ms(HD44780_ANIMATE_PERIOD_MS);
+		} /* Whole lines, so the display ends where it started */
+#endif
+	}
+
+	return Display_Handle->State;
+}
+
+/**
+  * @brief  Meant for end-user. Returns a timestamp from the delay backend, the time base of
+  * 		Display_Handle->Stats.Blocked_Time and trace records.
+  * @retval DWT cycles with HD44780_DELAY_DWT, SysTick milliseconds otherwise.
+  */
+uint32_t HD44780_Get_Timestamp(void)
+{
+#if (HD44780_DELAY_BACKEND == HD44780_DELAY_DWT)
+	return DWT->CYCCNT;
+#else
+	return HAL_GetTick();
+#endif
+}
+
+#if (HD44780_USE_STATS == 1)
+/**
+  * @brief  Meant for end-user. Zeroes the counters in Display_Handle->Stats, e.g. before measuring one screen update.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  */
+void HD44780_Reset_Stats(HD44780_HandleTypeDef *Display_Handle)
+{
+	memset(&Display_Handle->Stats, 0, sizeof(Display_Handle->Stats));
+}
+#endif
+
+#if (HD44780_TRACE_DEPTH > 0)
+/**
+  * @brief  Meant for end-user. Removes the oldest record from the trace ring, so the trace can be
+  * 		printed over SWO/UART from the main loop.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Receives the record.
+  * @retval False if the trace is empty.
+  */
+bool HD44780_Trace_Read(HD44780_HandleTypeDef *Display_Handle, HD44780_TraceTypeDef *Record)
+{
+	if (Display_Handle->Trace_Count == 0) {
+		return false;
+	}
+
+	const uint16_t Oldest = (uint16_t)((Display_Handle->Trace_Head + HD44780_TRACE_DEPTH - Display_Handle->Trace_Count) % HD44780_TRACE_DEPTH);
+	*Record = Display_Handle->Trace[Oldest];
+	Display_Handle->Trace_Count--;
+	return true;
+}
+#endif
+
+#if (HD44780_FRAME_BUFFERS > 0)
+/**
+  * @brief  Meant for end-user. Clears the back buffer. Nothing is sent to the display until HD44780_Flush().
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  */
+void HD44780_Frame_Clear(HD44780_HandleTypeDef *Display_Handle)
+{
+	memset(Display_Handle->Back_Buffer, '\0', (Display_Handle->Rows * Display_Handle->Cols));
+}
+
+/**
+  * @brief  Meant for end-user. Writes a string into the back buffer starting at the given coordinates.
+  * 		Continues on the next row when the current one is full and stops at the end of the buffer.
+  * 		Nothing is sent to the display until HD44780_Flush().
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Row index (0-indexed).
+  * @param	Column index (0-indexed).
+  * @param	String to write.
+  */
+void HD44780_Frame_Write(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column, const char *str)
+{
+	if ((row >= Display_Handle->Rows) | (column >= Display_Handle->Cols)) {
+		return;
+	}
+
+	const uint16_t NumElements = (Display_Handle->Rows * Display_Handle->Cols);
+	for (uint16_t index = ((row * Display_Handle->Cols) + column); (index < NumElements) && (*str != '\0'); index++) {
+		Display_Handle->Back_Buffer[index] = *str++;
+	}
+}
+
+/**
+  * @brief  Meant for end-user. printf() into the back buffer without a staging buffer or heap use.
+  * 		Supports %d %i %u %x %X %c %s %% with the '-' and '0' flags, a width and the 'l' modifier.
+  * 		Wraps like HD44780_Frame_Write() and stops at the end of the buffer. Nothing is sent to the
+  * 		display until HD44780_Flush().
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Row index (0-indexed).
+  * @param	Column index (0-indexed).
+  * @param	Format string, followed by its arguments.
+  */
+void HD44780_Frame_Printf(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column, const char *format, ...)
+{
+	if ((row >= Display_Handle->Rows) | (column >= Display_Handle->Cols)) {
+		return;
+	}
+
+	const uint16_t NumElements = (Display_Handle->Rows * Display_Handle->Cols);
+	uint16_t Index = ((row * Display_Handle->Cols) + column);
+	char Digits[HD44780_DIGITS_LEN];
+	va_list Args;
+	va_start(Args, format);
+
+	while ((*format != '\0') && (Index < NumElements)) {
+		if (*format != '%') {
+			Display_Handle->Back_Buffer[Index++] = *format++;
+			continue;
+		}
+		format++;
+
+		bool Left = false;
+		char Pad = ' ';
+		uint8_t Width = 0;
+		bool Long = false;
+
+		for (; (*format == '-') | (*format == '0'); format++) {
+			if (*format == '-') {
+				Left = true;
+			}
+
+			else {
+				Pad = '0';
+			}
+		} /* Flags */
+
+		for (; (*format >= '0') && (*format <= '9'); format++) {
+			Width = (uint8_t)((Width * 10) + (*format - '0'));
+		}
+
+		if (*format == 'l') {
+			Long = true;
+			format++;
+		}
+
+		switch (*format) {
+			case 'd':
+			case 'i': {
+				const int32_t Value = Long ? (int32_t)va_arg(Args, long) : (int32_t)va_arg(Args, int);
+				const uint32_t Magnitude = (Value < 0) ? ((uint32_t)(-(Value + 1)) + 1) : (uint32_t)Value;
+				const uint8_t Length = HD44780_Format_Digits(Digits, Magnitude, 10, 0, 'A');
+				HD44780_Frame_Number(Display_Handle, &Index, NumElements, Digits, Length, (Value < 0), Width, Pad, Left);
+				break;
+			}
+
+			case 'u':
+			case 'x':
+			case 'X': {
+				const uint32_t Value = Long ? (uint32_t)va_arg(Args, unsigned long) : (uint32_t)va_arg(Args, unsigned int);
+				const uint8_t Base = (*format == 'u') ? 10 : 16;
+				const uint8_t Length = HD44780_Format_Digits(Digits, Value, Base, 0, ((*format == 'x') ? 'a' : 'A'));
+				HD44780_Frame_Number(Display_Handle, &Index, NumElements, Digits, Length, false, Width, Pad, Left);
+				break;
+			}
+
+			case 'c':
+				Digits[0] = (char)va_arg(Args, int);
+				HD44780_Frame_Number(Display_Handle, &Index, NumElements, Digits, 1, false, Width, ' ', Left);
+				break;
+
+			case 's': {
+				const char *str = va_arg(Args, const char *);
+				uint16_t Length = 0;
+				while ((str[Length] != '\0') && (Length < NumElements)) {
+					Length++;
+				} /* Bounded, no strlen() */
+
+				uint16_t Padding = (Width > Length) ? (uint16_t)(Width - Length) : 0;
+				for (; !Left && (Padding > 0) && (Index < NumElements); Padding--) {
+					Display_Handle->Back_Buffer[Index++] = ' ';
+				}
+				for (uint16_t i = 0; (i < Length) && (Index < NumElements); i++) {
+					Display_Handle->Back_Buffer[Index++] = str[i];
+				}
+				for (; (Padding > 0) && (Index < NumElements); Padding--) {
+					Display_Handle->Back_Buffer[Index++] = ' ';
+				}
+				break;
+			}
+
+			case '%':
+				Display_Handle->Back_Buffer[Index++] = '%';
+				break;
+
+			default:
+				va_end(Args);
+				return; /* Unsupported conversion, also stops at a trailing '%' */
+		}
+		format++;
+	}
+
+	va_end(Args);
+}
+
+/**
+  * @brief  Meant for end-user. Sets up a text canvas larger than the display, backed by a buffer
+  * 		of Rows * Width characters owned by the caller. The canvas is filled with blanks and the
+  * 		view starts in its top left corner.
+  * @param  Canvas to set up, typically a static or global of the application.
+  * @param	Buffer of at least Rows * Width characters.
+  * @param	Number of canvas rows.
+  * @param	Number of canvas columns.
+  */
+void HD44780_Canvas_Init(HD44780_CanvasTypeDef *Canvas, char *Buffer, uint8_t Rows, uint16_t Width)
+{
+	Canvas->Buffer = Buffer;
+	Canvas->Rows = Rows;
+	Canvas->Width = Width;
+	Canvas->View_Row = 0;
+	Canvas->View_Column = 0;
+	Canvas->Dirty = false;
+	memset(Buffer, ' ', (size_t)Rows * Width);
+}
+
+/**
+  * @brief  Meant for end-user. Writes a string into a canvas row, cut at the end of the row.
+  * 		Nothing is sent to the display until HD44780_Canvas_View().
+  * @param  Canvas set up with HD44780_Canvas_Init().
+  * @param	Canvas row index (0-indexed).
+  * @param	Canvas column index (0-indexed).
+  * @param	String to write.
+  */
+void HD44780_Canvas_Write(HD44780_CanvasTypeDef *Canvas, uint8_t row, uint16_t column, const char *str)
+{
+	if (row >= Canvas->Rows) {
+		return;
+	}
+
+	char *Cell = &Canvas->Buffer[((uint32_t)row * Canvas->Width)];
+	for (; (column < Canvas->Width) && (*str != '\0'); column++) {
+		Cell[column] = *str++;
+	}
+	Canvas->Dirty = true;
+}
+
+/**
+  * @brief  Meant for end-user. Shows the canvas with row/column in the top left corner, clamped so
+  * 		the view stays on the canvas. The canvas owns the whole display while shown.
+  * 		On 1 and 2 line displays a canvas no wider than a DDRAM line (80/40 characters) is
+  * 		loaded into DDRAM on its first sideways move, after which every step sideways is one
+  * 		display shift command per column (pg. 11). Anything else is drawn into the back buffer
+  * 		and sent with HD44780_Flush(), which only rewrites the cells that changed.
+  * 		Call again after HD44780_Canvas_Write() to show the new text.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Canvas set up with HD44780_Canvas_Init().
+  * @param	Canvas row shown in the top row.
+  * @param	Canvas column shown in the leftmost column.
+  */
+HD44780_State HD44780_Canvas_View(HD44780_HandleTypeDef *Display_Handle, HD44780_CanvasTypeDef *Canvas, uint16_t row, uint16_t column)
+{
+	HD44780_Check_Health(Display_Handle);
+
+	const uint8_t LineLength = HD44780_LINE_LEN(Display_Handle->Rows);
+	const uint16_t LastRow = (Canvas->Rows > Display_Handle->Rows) ? (uint16_t)(Canvas->Rows - Display_Handle->Rows) : 0;
+	const uint16_t LastColumn = (Canvas->Width > Display_Handle->Cols) ? (uint16_t)(Canvas->Width - Display_Handle->Cols) : 0;
+	row = (row > LastRow) ? LastRow : row;
+	column = (column > LastColumn) ? LastColumn : column;
+
+	bool Hardware = (Display_Handle->Rows <= 2) && (Canvas->Width <= LineLength) && (row == Canvas->View_Row) && !Canvas->Dirty;
+	for (uint8_t i = 0; i < Display_Handle->Rows; i++) {
+		if (Display_Handle->Scroll[i].Text != NULL) {
+			Hardware = false;
+		}
+	} /* The scroll engine owns the shift */
+
+	if ((Display_Handle->Canvas != NULL) && (!Hardware || (Display_Handle->Canvas != Canvas))) {
+		HD44780_Canvas_Release(Display_Handle);
+	}
+
+	if (Hardware && (Display_Handle->Canvas == NULL) && !Display_Handle->Scroll_Hardware && (column != Canvas->View_Column)) {
+		HD44780_Canvas_Load(Display_Handle, Canvas);
+	} /* One line write buys a single command for every following column */
+
+	Canvas->View_Row = row;
+	Canvas->View_Column = column;
+
+	if (Display_Handle->Canvas == Canvas) {
+		HD44780_Canvas_Shift(Display_Handle, column);
+		return Display_Handle->State;
+	}
+
+	for (uint8_t i = 0; i < Display_Handle->Rows; i++) {
+		for (uint8_t j = 0; j < Display_Handle->Cols; j++) {
+			Display_Handle->Back_Buffer[(i * Display_Handle->Cols) + j] = HD44780_Canvas_Cell(Canvas, (uint16_t)(row + i), (uint16_t)(column + j));
+		}
+	}
+	Canvas->Dirty = false;
+
+	return HD44780_Flush(Display_Handle);
+}
+
+/**
+  * @brief  Meant for end-user. Binds a fixed-width numeric field to a position of the back buffer.
+  * 		Nothing is written until the first HD44780_Field_Set().
+  * @param  Field to set up, typically a static or global of the application.
+  * @param	Row index (0-indexed).
+  * @param	Column index of the leftmost cell (0-indexed).
+  * @param	Number of cells, clipped at the end of the row.
+  * @param	HD44780_FIELD_INT, HD44780_FIELD_FIXED or HD44780_FIELD_HEX.
+  * @param	Digits after the point for HD44780_FIELD_FIXED, ignored otherwise.
+  */
+void HD44780_Field_Init(HD44780_FieldTypeDef *Field, uint8_t row, uint8_t column, uint8_t Width, HD44780_Field_Format Format, uint8_t Decimals)
+{
+	Field->Row = row;
+	Field->Column = column;
+	Field->Width = Width;
+	Field->Format = Format;
+	Field->Decimals = (Format == HD44780_FIELD_FIXED) ? ((Decimals > HD44780_FIELD_MAX_DECIMALS) ? HD44780_FIELD_MAX_DECIMALS : Decimals) : 0;
+	Field->Value = 0;
+}
+
+/**
+  * @brief  Meant for end-user. Writes a value right aligned into its field of the back buffer,
+  * 		also when it didn't change: the cells may have been cleared or overwritten since. Since
+  * 		HD44780_Flush() only sends cells that differ from the display, going from 21.5 to 21.6
+  * 		costs one character write. Values that don't fit the width show as '*' in every cell.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param  Field set up with HD44780_Field_Init().
+  * @param	Value, scaled by 10^Decimals for HD44780_FIELD_FIXED.
+  */
+void HD44780_Field_Set(HD44780_HandleTypeDef *Display_Handle, HD44780_FieldTypeDef *Field, int32_t Value)
+{
+	if ((Field->Row >= Display_Handle->Rows) | (Field->Column >= Display_Handle->Cols)) {
+		return;
+	}
+
+	Field->Value = Value;
+
+	const uint16_t Start = ((Field->Row * Display_Handle->Cols) + Field->Column);
+	const uint8_t Room = (uint8_t)(Display_Handle->Cols - Field->Column);
+	const uint8_t Width = (Field->Width < Room) ? Field->Width : Room;
+	const bool Negative = ((Field->Format != HD44780_FIELD_HEX) && (Value < 0));
+	const uint32_t Magnitude = Negative ? ((uint32_t)(-(Value + 1)) + 1) : (uint32_t)Value;
+	char Digits[HD44780_DIGITS_LEN];
+	uint8_t Length;
+	uint16_t Index = Start;
+
+	if (Field->Format == HD44780_FIELD_HEX) {
+		Length = HD44780_Format_Digits(Digits, Magnitude, 16, 0, 'A');
+	}
+
+	else {
+		Length = HD44780_Format_Digits(Digits, Magnitude, 10, Field->Decimals, 'A');
+	}
+
+	if ((Length + (Negative ? 1 : 0)) > Width) {
+		memset(&Display_Handle->Back_Buffer[Start], '*', Width);
+		return;
+	} /* Overflow */
+
+	HD44780_Frame_Number(Display_Handle, &Index, (uint16_t)(Start + Width), Digits, Length, Negative, Width,
+			((Field->Format == HD44780_FIELD_HEX) ? '0' : ' '), false);
+}
+
+/**
+  * @brief  Meant for end-user. Brings the display up to date with the back buffer: publishes it with
+  * 		HD44780_Swap() and sends it at once. Compares the snapshot against the DDRAM mirror in
+  * 		Display_Handle->Text (the front frame) and only sends
+  * 		the runs of characters that changed, each preceded by one set DDRAM address command. Short
+  * 		gaps between runs are rewritten when that is cheaper than the jump, and the display is
+  * 		cleared first when that beats the incremental update (see HD44780_Flush_Cost()).
+  * 		Leaves the cursor after the last character written.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  */
+HD44780_State HD44780_Flush(HD44780_HandleTypeDef *Display_Handle)
+{
+	HD44780_Check_Health(Display_Handle);
+
+	HD44780_Swap(Display_Handle);
+	HD44780_Take_Frame(Display_Handle);
+	HD44780_Send_Frame(Display_Handle);
+
+	return Display_Handle->State;
+}
+
+/**
+  * @brief  Meant for end-user. Publishes the back buffer as the next frame without touching the bus,
+  * 		so producers never wait for a transfer. The back buffer and the published frame trade places
+  * 		with interrupts masked, then the back buffer is refilled with the published frame so drawing
+  * 		continues from it. HD44780_Process() sends the newest published frame; frames published in
+  * 		between are skipped, never mixed. Call from one producer context at a time.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  */
+void HD44780_Swap(HD44780_HandleTypeDef *Display_Handle)
+{
+	const uint32_t PriMask = __get_PRIMASK();
+	__disable_irq();
+
+	char *Published = Display_Handle->Back_Buffer;
+	Display_Handle->Back_Buffer = Display_Handle->Ready_Frame;
+	Display_Handle->Ready_Frame = Published;
+	Display_Handle->Frame_Ready = true;
+
+	__set_PRIMASK(PriMask);
+
+#if (HD44780_FRAME_BUFFERS == 3)
+	memcpy(Display_Handle->Back_Buffer, Published, (Display_Handle->Rows * Display_Handle->Cols)); /* The flush engine only reads it */
+#endif
+}
+
+/**
+  * @brief  Meant for end-user. Estimates what the next HD44780_Flush() will cost without sending
+  * 		anything, using the same plan HD44780_Flush() would pick.
+  * @param  Pointer to HD44780_HandleTypeDef struct.
+  * @param  Receives bus time plus waits, bus bytes, instruction count and whether the plan clears first.
+  */
+void HD44780_Flush_Cost(HD44780_HandleTypeDef *Display_Handle, HD44780_CostTypeDef *Cost)
+{
+	HD44780_Plan_Flush(Display_Handle, Display_Handle->Back_Buffer, Cost);
+}
+
+#endif /* HD44780_FRAME_BUFFERS */
+
+/**
+  * @brief  Meant for end-user. Returns the character code that shows Glyph, for use in strings passed to
+  * 		HD44780_Print() or HD44780_Frame_Write(). Glyphs already in CGRAM are reused as is. Otherwise
+  * 		the least recently used slot that is neither shown nor in the back buffer is assigned, and the
+  * 		pattern is uploaded before the next HD44780_Print() or HD44780_Flush() writes any character.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Pointer to a const glyph bitmap.
+  * @retval Character code 0x08-0x0F, or ' ' when all 8 slots are on screen.
+  */
+char HD44780_Glyph(HD44780_HandleTypeDef *Display_Handle, const HD44780_GlyphTypeDef *Glyph)
+{
+	uint8_t Victim = HD44780_GLYPH_SLOTS;
+	const uint16_t Now = ++Display_Handle->Glyph_Clock;
+
+	for (uint8_t Slot = 0; Slot < HD44780_GLYPH_SLOTS; Slot++) {
+		if (Display_Handle->Glyph_Slot[Slot] == Glyph) {
+			Display_Handle->Glyph_Used[Slot] = Now;
+			return (char)HD44780_GLYPH_CODE(Slot);
+		}
+	} /* Resident, no upload */
+
+	for (uint8_t Slot = 0; Slot < HD44780_GLYPH_SLOTS; Slot++) {
+		if (Display_Handle->Glyph_Slot[Slot] == NULL) {
+			Victim = Slot;
+			break;
+		} /* Free slot */
+
+		if (((Victim == HD44780_GLYPH_SLOTS) || ((uint16_t)(Now - Display_Handle->Glyph_Used[Slot]) > (uint16_t)(Now - Display_Handle->Glyph_Used[Victim])))
+				&& !HD44780_Glyph_On_Screen(Display_Handle, Slot)) {
+			Victim = Slot;
+		}
+	}
+
+	if (Victim == HD44780_GLYPH_SLOTS) {
+		return ' ';
+	} /* Every slot is in use on screen */
+
+	Display_Handle->Glyph_Slot[Victim] = Glyph;
+	Display_Handle->Glyph_Used[Victim] = Now;
+	Display_Handle->Glyph_Pending |= (uint8_t)(1 << Victim);
+
+	return (char)HD44780_GLYPH_CODE(Victim);
+}
+
+#if (HD44780_FRAME_BUFFERS > 0)
+/**
+  * @brief  Meant for end-user. Places a glyph in the back buffer, see HD44780_Glyph(). Repeated frames
+  * 		reuse the resident slot, so neither the pattern nor the cell is sent again.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Row index (0-indexed).
+  * @param	Column index (0-indexed).
+  * @param	Pointer to a const glyph bitmap.
+  */
+void HD44780_Frame_Glyph(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column, const HD44780_GlyphTypeDef *Glyph)
+{
+	if ((row >= Display_Handle->Rows) | (column >= Display_Handle->Cols)) {
+		return;
+	}
+
+	Display_Handle->Back_Buffer[(row * Display_Handle->Cols) + column] = HD44780_Glyph(Display_Handle, Glyph);
+}
+
+/**
+  * @brief  Meant for end-user. Starts scrolling a row, moved one position every Period_ms by
+  * 		HD44780_Process(). Strings longer than the row slide through it followed by
+  * 		HD44780_SCROLL_GAP blanks, shorter ones wrap around the row. When every row scrolls the
+  * 		same way at the same speed the display shift instruction is used instead of rewriting the
+  * 		rows, see HD44780_Scroll_Select(). HD44780_ALL_ROWS with a NULL string shifts whatever is
+  * 		currently shown. The string must stay valid until the row is stopped.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Row index (0-indexed) or HD44780_ALL_ROWS.
+  * @param	String to scroll, NULL to scroll the current contents (HD44780_ALL_ROWS only).
+  * @param	HD44780_SCROLL_LEFT or HD44780_SCROLL_RIGHT.
+  * @param	Milliseconds between steps.
+  */
+HD44780_State HD44780_Scroll_Start(HD44780_HandleTypeDef *Display_Handle, uint8_t row, const char *str, HD44780_Scroll_Direction Direction, uint16_t Period_ms)
+{
+	HD44780_Check_Health(Display_Handle);
+
+	const uint8_t FirstRow = (row == HD44780_ALL_ROWS) ? 0 : row;
+	const uint8_t LastRow = (row == HD44780_ALL_ROWS) ? Display_Handle->Rows : (uint8_t)(row + 1);
+	const uint32_t Now = HAL_GetTick();
+
+	if ((FirstRow >= Display_Handle->Rows) | ((str == NULL) && (row != HD44780_ALL_ROWS))) {
+		return Display_Handle->State;
+	}
+
+	HD44780_Canvas_Release(Display_Handle);
+
+	for (uint8_t i = 0; i < Display_Handle->Rows; i++) {
+		HD44780_ScrollTypeDef *Scroll = &Display_Handle->Scroll[i];
+
+		if ((i >= FirstRow) && (i < LastRow)) {
+			Scroll->Text = (str != NULL) ? str : &Display_Handle->Text[i * Display_Handle->Cols];
+			Scroll->Length = (str != NULL) ? (uint16_t)strlen(str) : Display_Handle->Cols;
+			Scroll->Offset = 0;
+			Scroll->Period_ms = Period_ms;
+			Scroll->Steps = 0;
+			Scroll->Direction = Direction;
+		}
+		Scroll->Last_Tick = Now; /* Keep rows in step */
+	}
+
+	if (str == NULL) {
+		Display_Handle->Scroll_Hardware = true;
+		return Display_Handle->State;
+	} /* Already in DDRAM, only the shift can move it */
+
+	HD44780_Scroll_Select(Display_Handle);
+
+	return Display_Handle->State;
+}
+
+/**
+  * @brief  Meant for end-user. Stops scrolling a row and leaves its current picture on the display.
+  * 		Rows moved by the display shift instruction are put back in place with return home first.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Row index (0-indexed) or HD44780_ALL_ROWS.
+  */
+HD44780_State HD44780_Scroll_Stop(HD44780_HandleTypeDef *Display_Handle, uint8_t row)
+{
+	HD44780_Check_Health(Display_Handle);
+
+	for (uint8_t i = 0; i < Display_Handle->Rows; i++) {
+		if ((row == HD44780_ALL_ROWS) | (row == i)) {
+			Display_Handle->Scroll[i].Text = NULL;
+		}
+	}
+
+	HD44780_Scroll_Select(Display_Handle);
+
+	return Display_Handle->State;
+}
+
+/**
+  * @brief  Meant for end-user. Pauses or resumes every scrolling row without losing its position.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	True to pause, false to resume.
+  */
+void HD44780_Scroll_Pause(HD44780_HandleTypeDef *Display_Handle, bool Pause)
+{
+	if (!Pause && Display_Handle->Scroll_Paused) {
+		const uint32_t Now = HAL_GetTick();
+		for (uint8_t row = 0; row < Display_Handle->Rows; row++) {
+			Display_Handle->Scroll[row].Last_Tick = Now;
+		}
+	} /* Resume with a full period, not a burst of missed steps */
+
+	Display_Handle->Scroll_Paused = Pause;
+}
+#endif /* HD44780_FRAME_BUFFERS */
+
+/**
+  * @brief  Meant for end-user. Call from the main loop or a periodic timer callback. Draws the cells
+  * 		posted with HD44780_Post_Char(), sends the frame published with HD44780_Swap(), steps the
+  * 		scroll engine and, with HD44780_USE_ASYNC, services the transmit queues of every display on
+  * 		the same I2C bus as Display_Handle: starts the next frame once the bus is idle and the
+  * 		previous instruction (e.g. clear display) has finished executing.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  */
+HD44780_State HD44780_Process(HD44780_HandleTypeDef *Display_Handle)
+{
+	HD44780_Check_Health(Display_Handle);
+#if (HD44780_POST_DEPTH > 0)
+	HD44780_Post_Drain(Display_Handle);
+#endif
+#if (HD44780_FRAME_BUFFERS > 0)
+	if (HD44780_Take_Frame(Display_Handle)) {
+		HD44780_Send_Frame(Display_Handle);
+	} /* Published with HD44780_Swap() */
+	HD44780_Scroll_Tick(Display_Handle);
+#endif
+#if (HD44780_SCRUB_INTERVAL_MS > 0)
+	if ((HAL_GetTick() - Display_Handle->Scrub_Tick) >= HD44780_SCRUB_INTERVAL_MS) {
+		Display_Handle->Scrub_Tick = HAL_GetTick();
+		HD44780_Scrub(Display_Handle);
+	} /* One row per interval keeps each call short */
+#endif
+#if (HD44780_USE_ASYNC == 1)
+	HD44780_Service_Queue(Display_Handle);
+#endif
+
+	return Display_Handle->State;
+}
+
+#if (HD44780_POST_DEPTH > 0)
+/**
+  * @brief  Meant for end-user. Safe to call from any interrupt priority and from the main loop: only
+  * 		stores the write in the handle's ring, with interrupts masked for a few instructions, and
+  * 		never touches the bus or waits. HD44780_Process() draws it later. On a full ring the
+  * 		HD44780_POST_OVERFLOW policy decides which write is lost.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Row coordinate.
+  * @param	Column coordinate.
+  * @param	Character to show.
+  * @retval False if the coordinate is off the display or the write was dropped.
+  */
+bool HD44780_Post_Char(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column, char Character)
+{
+	if ((row >= Display_Handle->Rows) | (column >= Display_Handle->Cols)) {
+		return false;
+	}
+
+	bool Push = true;
+	bool Posted = true;
+	const uint32_t PriMask = __get_PRIMASK();
+	__disable_irq();
+#if (HD44780_POST_OVERFLOW == HD44780_POST_COALESCE)
+	const uint16_t Index = ((row * Display_Handle->Cols) + column);
+	if (Display_Handle->Post_Slot[Index] != 0) {
+		Display_Handle->Post[Display_Handle->Post_Slot[Index] - 1].Character = Character;
+		Push = false;
+	} /* Cell still waiting, only its latest character gets drawn */
+
+	else if (Display_Handle->Post_Count == HD44780_POST_DEPTH) {
+		Display_Handle->Post_Dropped++;
+		Push = false;
+		Posted = false;
+	}
+
+	else {
+		Display_Handle->Post_Slot[Index] = (uint8_t)(Display_Handle->Post_Head + 1);
+	}
+#else
+	if (Display_Handle->Post_Count == HD44780_POST_DEPTH) {
+		Display_Handle->Post_Tail = (uint8_t)((Display_Handle->Post_Tail + 1) % HD44780_POST_DEPTH);
+		Display_Handle->Post_Count--;
+		Display_Handle->Post_Dropped++;
+	} /* Oldest write is lost */
+#endif
+
+	if (Push) {
+		HD44780_PostTypeDef *Post = &Display_Handle->Post[Display_Handle->Post_Head];
+		Post->Row = row;
+		Post->Column = column;
+		Post->Character = Character;
+		Display_Handle->Post_Head = (uint8_t)((Display_Handle->Post_Head + 1) % HD44780_POST_DEPTH);
+		Display_Handle->Post_Count++;
+	}
+	__set_PRIMASK(PriMask);
+
+	return Posted;
+}
+
+/**
+  * @brief  Meant for end-user. Posts a string cell by cell with HD44780_Post_Char(), same interrupt
+  * 		safety. Stops at the end of the row.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  * @param	Row coordinate.
+  * @param	Column of the first character.
+  * @param	String to show.
+  * @retval Number of characters posted.
+  */
+uint8_t HD44780_Post_Text(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column, const char *str)
+{
+	uint8_t Posted = 0;
+
+	for (uint8_t i = 0; (str[i] != '\0') && ((column + i) < Display_Handle->Cols); i++) {
+		if (HD44780_Post_Char(Display_Handle, row, (uint8_t)(column + i), str[i])) {
+			Posted++;
+		}
+	}
+	return Posted;
+}
+#endif
+
+#if (HD44780_USE_ASYNC == 1)
+/**
+  * @brief  Meant for end-user. Call from HAL_I2C_MasterTxCpltCallback() when HD44780_DEFINE_HAL_CALLBACKS
+  * 		is 0. Retires the frame that just finished and starts the next ready frame on that bus.
+  * @param  Pointer to HAL I2C_HandleTypeDef that completed the transfer.
+  */
+void HD44780_I2C_TxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	for (uint8_t i = 0; i < HD44780_MAX_DISPLAYS; i++) {
+		HD44780_HandleTypeDef *Display_Handle = Async_Handles[i];
+
+		if ((Display_Handle == NULL) || (Display_Handle->HW061_I2C_Handle != hi2c) || !Display_Handle->Queue_Active) {
+			continue;
+		}
+
+		const uint16_t Delay_us = Display_Handle->Queue[Display_Handle->Queue_Head].Delay_us;
+		Display_Handle->Queue_Head = (uint8_t)((Display_Handle->Queue_Head + 1) % HD44780_QUEUE_DEPTH);
+		Display_Handle->Queue_Count--;
+		Display_Handle->Queue_Active = false;
+
+		if (Delay_us > HD44780_FRAME_LEADIN_US) {
+			Display_Handle->Queue_Timestamp = HD44780_Get_Timestamp();
+			Display_Handle->Queue_Delay_us = Delay_us;
+			Display_Handle->Queue_Waiting = true;
+		} /* Clear/home still executing, also holds off a frame queued after the queue drained */
+
+		if (Display_Handle->Queue_Count == 0) {
+			Display_Handle->State = HD44780_READY;
+			HD44780_TxCpltCallback(Display_Handle);
 		}
+
+		/* Round robin: the next display on this bus goes first */
+		HD44780_Schedule_Bus(hi2c, (uint8_t)(i + 1));
+		return;
 	}
+}
+
+/**
+  * @brief  Meant for end-user. Call from HAL_I2C_ErrorCallback() when HD44780_DEFINE_HAL_CALLBACKS is 0.
+  * 		Drops everything queued and sets Display_Handle->State to HD44780_TIMEOUT.
+  * @param  Pointer to HAL I2C_HandleTypeDef that reported the error.
+  */
+void HD44780_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	for (uint8_t i = 0; i < HD44780_MAX_DISPLAYS; i++) {
+		HD44780_HandleTypeDef *Display_Handle = Async_Handles[i];
 
-	if (TextPresent) {
-		int BytesPerRow = 80/HD44780_NUM_ROWS;
-		int NumberOfShifts = (NumberOfScrolls * BytesPerRow);
-		for (int i = 0; i < NumberOfShifts; i++) {
-			HD44780_Send_Command(Display_Handle, 0x1C, false);
-			HAL_Delay(100); /* Scroll speed */
+		if ((Display_Handle == NULL) || (Display_Handle->HW061_I2C_Handle != hi2c) || !Display_Handle->Queue_Active) {
+			continue;
 		}
+
+		Display_Handle->Queue_Head = Display_Handle->Queue_Tail;
+		Display_Handle->Queue_Count = 0;
+		Display_Handle->Queue_Active = false;
+		Display_Handle->Queue_Waiting = false;
+		HD44780_Fault(Display_Handle, HD44780_ERROR); /* Re-initialized from the main loop */
+		return;
 	}
 }
+
+/**
+  * @brief  Executes from interrupt context once the transmit queue has drained. Weak so the user can
+  * 		override it, e.g. to start the next screen update.
+  * @param  Pointer to HD44780_HandleTypeDef struct that user defines in beginning of program.
+  */
+__weak void HD44780_TxCpltCallback(HD44780_HandleTypeDef *Display_Handle)
+{
+	(void)Display_Handle;
+}
+
+#if (HD44780_DEFINE_HAL_CALLBACKS == 1)
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	HD44780_I2C_TxCpltCallback(hi2c);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	HD44780_I2C_ErrorCallback(hi2c);
+}
+#endif
+#endif /* HD44780_USE_ASYNC */
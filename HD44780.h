@@ -12,15 +12,94 @@
 #define INC_HD44780_H_
 
 /* ####################### INCLUDES ############################# */
-#include "stm32f1xx_hal.h"
+#ifndef HD44780_HAL_HEADER
+#define HD44780_HAL_HEADER      "stm32f1xx_hal.h" /* Override with -D for other STM32 families or a host stub */
+#endif
+#include HD44780_HAL_HEADER
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /* ####################### USER DEFINES ############################### */
-#define HD44780_NUM_ROWS        2
+#define HD44780_NUM_ROWS        2         /* Geometry and address used by HD44780_Init() */
 #define HD44780_NUM_COLS        16
 #define HW061_I2C_ADDR          (0x27<<1) /* PCF8574 (pg. 13) */
+#ifndef HD44780_MAX_ROWS
+#define HD44780_MAX_ROWS        HD44780_NUM_ROWS /* Largest display passed to HD44780_Init_Display(), sizes Text buffers */
+#endif
+#ifndef HD44780_MAX_COLS
+#define HD44780_MAX_COLS        HD44780_NUM_COLS /* Override both with -D for every file that includes this header */
+#endif
+
+/* Delay backend used for sub-millisecond timing (HD44780_DELAY_HAL, HD44780_DELAY_DWT or HD44780_DELAY_TIM) */
+#define HD44780_DELAY_BACKEND   HD44780_DELAY_DWT
+/* #define HD44780_DELAY_TIM_HANDLE  htim2 */ /* 1MHz free running TIM, only used by HD44780_DELAY_TIM */
+
+/* How to wait for instructions to finish (HD44780_EXEC_BUSY_FLAG, HD44780_EXEC_TIMED or HD44780_EXEC_TIMED_VERIFY) */
+#define HD44780_DEFAULT_EXEC_MODE       HD44780_EXEC_BUSY_FLAG
+#define HD44780_I2C_CLOCK_HZ            100000 /* Used to skip waits already covered by bus time */
+#define HD44780_CURSOR_CHECK_INTERVAL   0      /* Read back the address counter every N prints, 0 = never */
+#define HD44780_SCRUB_INTERVAL_MS       0      /* HD44780_Process() reads back one row and repairs it every N ms, 0 = never */
+#define HD44780_CALIBRATE_AT_INIT       0      /* Measure the module's execution times with HD44780_Calibrate() during init */
+#define HD44780_CALIBRATE_MARGIN_PCT    25     /* Added to the measured times */
+#define HD44780_CALIBRATE_TRIALS        8      /* Return home instructions timed, each one halves the uncertainty */
+
+/* How to spend waits (HD44780_WAIT_SPIN or HD44780_WAIT_SLEEP), per display with HD44780_Set_Wait_Mode() */
+#define HD44780_DEFAULT_WAIT_MODE       HD44780_WAIT_SPIN
+#define HD44780_SLEEP_WAKE_US           1000   /* SysTick period. Sleep only while more than this is left, the rest is spun */
+
+/* Start-up */
+#define HD44780_READY_TRIALS            3    /* PCF8574 address probes before HD44780_Init_Display() gives up */
+#define HD44780_READY_TIMEOUT_MS        10   /* Per probe */
+#define HD44780_WARM_RESTART            1    /* Skip the software reset if the HD44780 kept its 4-bit setup over an MCU reset */
+
+/* Error recovery. A failing display never blocks the caller for longer than the retries below */
+#define HD44780_I2C_TIMEOUT_MS          5    /* Per transfer, the longest frame takes <2ms at 100kHz */
+#define HD44780_MAX_RETRIES             2    /* Extra attempts after a failed transfer */
+#define HD44780_RETRY_BACKOFF_US        100  /* Wait before the first retry, doubled for each further one */
+#define HD44780_REINIT_INTERVAL_MS      500  /* Minimum time between automatic re-init attempts */
+/* #define HD44780_SCL_GPIO_PORT    GPIOB */      /* I2C pins for bus recovery, leave undefined to skip it */
+/* #define HD44780_SCL_GPIO_PIN     GPIO_PIN_6 */
+/* #define HD44780_SDA_GPIO_PORT    GPIOB */
+/* #define HD44780_SDA_GPIO_PIN     GPIO_PIN_7 */
+
+/* Non-blocking transmit queue. 0 = every call blocks until the HD44780 is done */
+#define HD44780_USE_ASYNC               0
+#define HD44780_ASYNC_METHOD            HD44780_ASYNC_DMA /* HD44780_ASYNC_DMA or HD44780_ASYNC_IT */
+#define HD44780_QUEUE_DEPTH             16 /* Frames per display */
+#define HD44780_QUEUE_FRAME_CHARS       4  /* Characters merged into one queued frame */
+#define HD44780_DEFINE_HAL_CALLBACKS    1  /* 0 if main.c already defines HAL_I2C_MasterTxCpltCallback() */
+#define HD44780_MAX_DISPLAYS            1  /* Displays sharing the transmit queue scheduler (0x20-0x27 on one bus) or the arena */
+
+/* CMSIS-RTOS2 port (HD44780_RTOS.c): waits of 1ms and longer use osDelay() so other tasks run meanwhile */
+#define HD44780_USE_RTOS                0
+
+/* Cell writes posted from interrupts with HD44780_Post_Char(), drawn by HD44780_Process() */
+#define HD44780_POST_DEPTH              0  /* Writes buffered per display (at most 255), 0 = no posting */
+#define HD44780_POST_OVERFLOW           HD44780_POST_COALESCE /* HD44780_POST_COALESCE or HD44780_POST_DROP_OLDEST */
+
+/* Instrumentation, read Display_Handle->Stats and HD44780_Trace_Read() */
+#define HD44780_USE_STATS               0  /* Per-display bus, wait and error counters */
+#define HD44780_TRACE_DEPTH             0  /* Timestamped instruction records kept per display, 0 = no trace */
+
+/* Scroll engine, stepped by HD44780_Process() */
+#define HD44780_SCROLL_GAP              4   /* Blank columns between the end and the restart of a scrolled string */
+#define HD44780_ANIMATE_PERIOD_MS       100 /* Step period used by HD44780_Animate_Text() */
+
+/* Memory footprint, the README lists what each option costs */
+#define HD44780_USE_SHADOW              1  /* Text mirror of DDRAM. 0 = write-only driver: no frames, scrolling, posting or scrub */
+#define HD44780_FRAME_BUFFERS           3  /* 3 = tear-free HD44780_Swap(), 1 = single back buffer, 0 = no framebuffer API */
+#define HD44780_USE_ARENA               0  /* Text and frames sized Rows * Cols and taken from one static pool at init */
+#define HD44780_ARENA_SIZE              (HD44780_MAX_DISPLAYS * HD44780_BUFFERS_PER_DISPLAY * HD44780_NUM_ELEMENTS) /* Characters */
+
+/* Transports other than the PCF8574, see HD44780_Init_Transport() */
+#define HD44780_GPIO_PULSE_US           1   /* Hold time of each GPIO port byte, covers the 450ns EN pulse width (pg. 49) */
+#define HD44780_HC595_TIMEOUT_MS        1   /* Per shifted byte */
 
 /* ####################### DRIVER DEFINES ############################### */
 /* I2C Control bits */
@@ -30,16 +109,121 @@
 #define HD44780_BACKLIGHT       (1 << 3)
 #define HD44780_FUNCTION_SET    (1 << 5)
 
+/* Shadowed instruction registers (pg. 24) */
+#define HD44780_ENTRY_MODE_SET  (1 << 2)
+#define HD44780_DISPLAY_CONTROL (1 << 3)
+#define HD44780_DISPLAY_BIT     (1 << 2) /* D */
+#define HD44780_CURSOR_BIT      (1 << 1) /* C */
+#define HD44780_BLINK_BIT       (1 << 0) /* B */
+#define HD44780_TWO_LINES       (1 << 3) /* N */
+#define HD44780_INCREMENT       (1 << 1) /* I/D */
+
+/* Delay backends */
+#define HD44780_DELAY_HAL       0 /* HAL_Delay(), every wait rounded up to 1ms */
+#define HD44780_DELAY_DWT       1 /* Cortex-M3 DWT cycle counter, needs SystemCoreClock */
+#define HD44780_DELAY_TIM       2 /* User TIM counting at 1MHz (HD44780_DELAY_TIM_HANDLE) */
+
+/* Timing (HD44780 pg. 24 Table 6, pg. 45-46 and pg. 52) */
+#define HD44780_T_POWER_ON_MS       40   /* Wait after VCC rises to 2.7V */
+#define HD44780_T_INIT_1_US         4100 /* After first 0x30 of software reset */
+#define HD44780_T_INIT_2_US         100  /* After second 0x30 of software reset */
+#define HD44780_T_EXEC_US           37   /* Most instructions and data writes */
+#define HD44780_T_CLEAR_US          1520 /* Clear display and return home */
+#define HD44780_T_DATA_DELAY_US     1    /* EN HIGH to valid data on reads (tDDR = 360ns) */
+#define HD44780_BUSY_TIMEOUT_MS     100  /* Busy flag polling gives up after this long */
+#define HD44780_PROBE_ADDRESS       0x4A /* Read back by the warm restart probe, 0x22 if the HD44780 is still in 8-bit mode */
+#define HD44780_FRAME_LEADIN_US     ((18UL * 1000000UL) / HD44780_I2C_CLOCK_HZ) /* Address + first port byte of a transfer */
+#define HD44780_BYTE_TIME_US        ((9UL * 1000000UL) / HD44780_I2C_CLOCK_HZ)  /* One byte + ACK, used by the flush planner */
+#define HD44780_POLL_PORT_BYTES     7    /* Busy flag check: EN pulse + upper and lower nibble reads */
+#define HD44780_POLL_TRANSFERS      5
+
+/* Compile time version of HD44780_Encode_Nibbles(): EN HIGH then LOW for the upper, then the lower nibble */
+#define HD44780_NIBBLE_STREAM(Value, ControlBits) \
+	(uint8_t)(((Value) & 0xF0) | (ControlBits) | HD44780_EN), (uint8_t)(((Value) & 0xF0) | (ControlBits)), \
+	(uint8_t)((((Value) << 4) & 0xF0) | (ControlBits) | HD44780_EN), (uint8_t)((((Value) << 4) & 0xF0) | (ControlBits))
+
+/* Burst frame lengths (PCF8574 port bytes per I2C transaction) */
+#define HD44780_COMMAND_FRAME_LEN   4 /* Upper + lower nibble, EN HIGH then LOW */
+#define HD44780_DATA_FRAME_LEN      5 /* RS setup byte + upper + lower nibble */
+
+/* Transmit queue */
+#define HD44780_ASYNC_DMA           0 /* HAL_I2C_Master_Transmit_DMA() */
+#define HD44780_ASYNC_IT            1 /* HAL_I2C_Master_Transmit_IT() */
+#define HD44780_QUEUE_FRAME_LEN     (HD44780_DATA_FRAME_LEN + (4 * (HD44780_QUEUE_FRAME_CHARS - 1)))
+
+/* Posting */
+#define HD44780_POST_COALESCE       0 /* A cell already waiting takes the new character, a full ring drops writes to other cells */
+#define HD44780_POST_DROP_OLDEST    1 /* A full ring overwrites its oldest write */
+
+/* DDRAM address of the first character of a row in 2-line mode. Rows 0/1 start the two 40 character
+ * lines, rows 2/3 continue them after Cols characters: 0x00/0x40/0x14/0x54 on a 20x4. See HD44780 pg. 11 */
+#define HD44780_ROW_OFFSET(Row, Cols)   ((((Row) & 1) ? 0x40 : 0x00) + (((Row) >> 1) * (Cols)))
+
+/* Scroll engine */
+#define HD44780_ALL_ROWS            0xFF /* Row argument of HD44780_Scroll_Start()/HD44780_Scroll_Stop() */
+#define HD44780_SHIFT_LEFT          0x18 /* Cursor/display shift, S/C = 1 (pg. 24) */
+#define HD44780_SHIFT_RIGHT         0x1C
+#define HD44780_LINE_LEN(Rows)      (((Rows) == 1) ? 80 : 40) /* Characters per DDRAM line, display shift wraps here */
+
+/* CGRAM glyph cache (pg. 13 Table 5, pg. 19) */
+#define HD44780_GLYPH_SLOTS         8    /* 5x8 character patterns in CGRAM */
+#define HD44780_GLYPH_CODE(Slot)    (0x08 + (Slot)) /* CGRAM is mirrored at 0x08-0x0F, keeps 0x00 free for NULL */
+
+/* Formatting */
+#define HD44780_FIELD_MAX_DECIMALS  9
+#define HD44780_DIGITS_LEN          12   /* 10 decimal digits of a 32-bit value, point and leading zero */
+
 /* Misc */
-#define HD44780_NUM_ELEMENTS    (HD44780_NUM_ROWS * HD44780_NUM_COLS)
+#define HD44780_NUM_ELEMENTS    (HD44780_MAX_ROWS * HD44780_MAX_COLS)
+#define HD44780_BUFFERS_PER_DISPLAY (HD44780_USE_SHADOW + HD44780_FRAME_BUFFERS) /* Text + frames */
+
+#if (HD44780_FRAME_BUFFERS != 0) && (HD44780_FRAME_BUFFERS != 1) && (HD44780_FRAME_BUFFERS != 3)
+#error "HD44780_FRAME_BUFFERS must be 0, 1 or 3"
+#endif
+#if (HD44780_USE_SHADOW == 0) && ((HD44780_FRAME_BUFFERS > 0) || (HD44780_POST_DEPTH > 0) || (HD44780_SCRUB_INTERVAL_MS > 0))
+#error "Frames, posting and the scrubber compare against the shadow, set HD44780_USE_SHADOW 1"
+#endif
+#if (HD44780_USE_ARENA == 1) && (HD44780_BUFFERS_PER_DISPLAY == 0)
+#error "Nothing to take from the arena without the shadow, set HD44780_USE_ARENA 0"
+#endif
 
 /* ####################### Enums ############################### */
 typedef enum {
 	HD44780_READY,
 	HD44780_BUSY,
-	HD44780_TIMEOUT
+	HD44780_TIMEOUT,            /* Busy flag stuck, display is re-initialized on a later call */
+	HD44780_ERROR               /* I2C transfer failed after HD44780_MAX_RETRIES, same recovery */
 } HD44780_State;
 
+typedef enum {
+	HD44780_EXEC_BUSY_FLAG,     /* Poll busy flag after every instruction */
+	HD44780_EXEC_TIMED,         /* Wait worst case execution time, no reads */
+	HD44780_EXEC_TIMED_VERIFY   /* Wait execution time, then confirm with one busy flag read */
+} HD44780_Exec_Mode;
+
+typedef enum {
+	HD44780_WAIT_SPIN,          /* Delay backend busy-waits, lowest latency */
+	HD44780_WAIT_SLEEP          /* WFI until SysTick or the I2C/DMA interrupt, needs interrupts enabled */
+} HD44780_Wait_Mode;
+
+typedef enum {
+	HD44780_SCROLL_LEFT,
+	HD44780_SCROLL_RIGHT
+} HD44780_Scroll_Direction;
+
+typedef enum {
+	HD44780_TRACE_COMMAND,      /* Instruction written, RS = 0 */
+	HD44780_TRACE_DATA,         /* Character or CGRAM line written, RS = 1 */
+	HD44780_TRACE_STATUS,       /* Busy flag and address counter read back */
+	HD44780_TRACE_READ          /* DDRAM character read back, RS = 1 */
+} HD44780_Trace_Type;
+
+typedef enum {
+	HD44780_FIELD_INT,          /* Signed decimal */
+	HD44780_FIELD_FIXED,        /* Signed decimal with Decimals digits after the point, 215 = "21.5" */
+	HD44780_FIELD_HEX           /* Unsigned, upper case, zero padded */
+} HD44780_Field_Format;
+
 typedef enum {
 	LCD1602_ON,
 	LCD1602_OFF
@@ -53,36 +237,290 @@ typedef enum {
 	CURSOR_ON,
 	CURSOR_OFF,
 	CURSOR_BLINK,
-	CURSOR_UNBLINK
+	CURSOR_UNBLINK,
+	BACKLIGHT_ON,
+	BACKLIGHT_OFF
 	//MOVE_CURSOR_RIGHT,
 	//MOVE_CURSOR_LEFT
 } HD44780_User_Command_List;
 
 /* ####################### Structs ############################### */
 typedef struct {
+	uint8_t                 Bytes[HD44780_QUEUE_FRAME_LEN]; /* PCF8574 port bytes, sent in one transfer */
+	uint8_t                 Length;
+	bool                    Mergeable;  /* Following data writes may be appended */
+	uint16_t                Delay_us;   /* Execution time needed before the next frame */
+} HD44780_FrameTypeDef;
+
+typedef struct {
+	uint32_t                Tx_Bytes;       /* Port bytes sent, I2C address bytes not included */
+	uint32_t                Rx_Bytes;
+	uint32_t                Transactions;   /* I2C transfers started */
+	uint32_t                Busy_Polls;     /* Busy flag reads */
+	uint32_t                Blocked_Time;   /* Waiting for instructions to finish, HD44780_Get_Timestamp() units */
+	uint32_t                HAL_Errors;     /* HAL I2C calls not returning HAL_OK */
+	uint32_t                Timeouts;       /* Busy flag still set after HD44780_BUSY_TIMEOUT_MS */
+	uint32_t                Sleep_Time;     /* Timed waits spent in WFI, microseconds */
+	uint32_t                Spin_Time;      /* Timed waits spent busy-waiting, microseconds */
+	uint32_t                Scrub_Repairs;  /* Cells HD44780_Scrub() found wrong on the display and rewrote */
+} HD44780_StatsTypeDef;
+
+typedef struct {
+	uint32_t                Timestamp;      /* HD44780_Get_Timestamp(): DWT cycles, or ms with the other delay backends */
+	HD44780_Trace_Type      Type;
+	uint8_t                 Value;          /* Instruction, character or status byte */
+} HD44780_TraceTypeDef;
+
+typedef struct {
+	uint8_t                 Lines[8];   /* Top to bottom, bits 4..0 = columns left to right */
+} HD44780_GlyphTypeDef;                 /* Declare const so the bitmap stays in flash */
+
+typedef struct {
+	uint8_t                 Row;
+	uint8_t                 Column;
+	uint8_t                 Width;      /* Cells owned by the field, value is right aligned */
+	uint8_t                 Decimals;   /* HD44780_FIELD_FIXED only, at most HD44780_FIELD_MAX_DECIMALS */
+	HD44780_Field_Format    Format;
+	int32_t                 Value;      /* Last value written into the back buffer */
+} HD44780_FieldTypeDef;
+
+typedef struct {
+	uint8_t                 Row;
+	uint8_t                 Column;
+	char                    Character;
+} HD44780_PostTypeDef;
+
+typedef struct {
+	const char              *Text;      /* String scrolled through the row, NULL when the row is idle */
+	uint16_t                Length;
+	uint16_t                Offset;     /* Index of Text shown in column 0 */
+	uint16_t                Period_ms;
+	uint16_t                Steps;      /* Steps left before the row stops on its own, 0 = until HD44780_Scroll_Stop() */
+	uint32_t                Last_Tick;
+	HD44780_Scroll_Direction Direction;
+} HD44780_ScrollTypeDef;
+
+typedef struct {
+	char                    *Buffer;       /* Rows * Width characters, row after row, no terminators */
+	uint8_t                 Rows;
+	uint16_t                Width;
+	uint16_t                View_Row;      /* Canvas cell shown in the top left corner */
+	uint16_t                View_Column;
+	bool                    Dirty;         /* Written since it was loaded into DDRAM */
+} HD44780_CanvasTypeDef;
+
+typedef struct {
+	uint32_t                Time_us;        /* Bus time plus execution waits */
+	uint32_t                Bus_Bytes;      /* Address, port and busy flag poll bytes */
+	uint16_t                Instructions;
+	bool                    Clear;          /* Plan starts with clear display and rewrites every non-blank cell */
+} HD44780_CostTypeDef;
+
+typedef struct HD44780_HandleTypeDef HD44780_HandleTypeDef;
+
+/* A backend replays the PCF8574 port bytes (RS, RW, EN, backlight, D4..D7 in bits 0..7) on its own pins */
+typedef struct {
+	bool                    (*Probe)(HD44780_HandleTypeDef *Display_Handle, uint32_t Trials, uint32_t Timeout_ms);
+	HAL_StatusTypeDef       (*Write)(HD44780_HandleTypeDef *Display_Handle, const uint8_t *PortBytes, uint16_t Length);
+	HAL_StatusTypeDef       (*Read)(HD44780_HandleTypeDef *Display_Handle, uint8_t *PortByte);
+	bool                    (*Can_Read)(HD44780_HandleTypeDef *Display_Handle); /* False = RW tied low, no busy flag */
+	uint16_t                Byte_Time_us;   /* Per port byte, used by the flush planner */
+	uint16_t                Leadin_us;      /* Start of a transfer until its first port byte reaches the HD44780 */
+	uint8_t                 Overhead_Bytes; /* Per transfer, the I2C address byte */
+} HD44780_TransportTypeDef;
+
+typedef struct {
+	GPIO_TypeDef            *Port;      /* All pins on one port, each port byte is a single BSRR write */
+	uint16_t                Pin[8];     /* GPIO_PIN_x per port bit: RS, RW, EN, backlight, D4, D5, D6, D7. 0 = not connected */
+} HD44780_GPIO_ConfigTypeDef;           /* D4..D7 open drain with pull-ups if RW is connected, the HD44780 drives them on reads */
+
+#if defined(HAL_SPI_MODULE_ENABLED)
+typedef struct {
+	SPI_HandleTypeDef       *SPI_Handle; /* 8-bit frames, MSB first: Q7..Q0 = port bits 7..0 */
+	GPIO_TypeDef            *Latch_Port; /* RCLK */
+	uint16_t                Latch_Pin;
+} HD44780_HC595_ConfigTypeDef;
+#endif
+
+struct HD44780_HandleTypeDef {
+	const HD44780_TransportTypeDef *Transport;
+	const void              *Transport_Config; /* HD44780_GPIO_ConfigTypeDef etc, NULL for the PCF8574 */
 	I2C_HandleTypeDef       *HW061_I2C_Handle;
+	uint16_t                I2C_Address;      /* PCF8574 address, shifted left by one */
+	uint8_t                 Rows;
+	uint8_t                 Cols;
+	uint8_t                 Row_Offsets[HD44780_MAX_ROWS]; /* DDRAM address of column 0, see HD44780_ROW_OFFSET */
 	uint8_t                 Cursor_Position[2];
-	char                    Text[HD44780_NUM_ELEMENTS];
+	uint8_t                 AddressCounter;   /* Software model of the HD44780 address counter (pg. 9) */
+	uint8_t                 Print_Count;      /* Prints since last HD44780_Verify_Cursor_Position() */
+	uint8_t                 Scrub_Row;        /* Row checked by the next HD44780_Scrub() */
+	uint32_t                Scrub_Tick;       /* HAL_GetTick() of the last scrub from HD44780_Process() */
+	uint8_t                 Port_Byte;        /* Last byte written to the port by a blocking transfer, EN always LOW */
+	uint8_t                 Backlight;        /* HD44780_BACKLIGHT or 0, carried by every port byte */
+	uint8_t                 Function_Set;     /* Shadows of the instruction registers, commands that match are skipped */
+	uint8_t                 Entry_Mode;
+	uint8_t                 Display_Control;
+#if (HD44780_USE_SHADOW == 1) && (HD44780_USE_ARENA == 1)
+	char                    *Text;            /* Front frame: mirror of DDRAM, Rows * Cols characters in the arena */
+#elif (HD44780_USE_SHADOW == 1)
+	char                    Text[HD44780_NUM_ELEMENTS];        /* Front frame: mirror of what is currently shown in DDRAM */
+#endif
+#if (HD44780_FRAME_BUFFERS > 0)
+#if (HD44780_USE_ARENA == 1)
+	char                    *Frame[HD44780_FRAME_BUFFERS];     /* Rows * Cols characters each in the arena */
+#else
+	char                    Frame[HD44780_FRAME_BUFFERS][HD44780_NUM_ELEMENTS]; /* Buffers behind the three pointers below */
+#endif
+	char                    *Back_Buffer;     /* Drawn by HD44780_Frame_*(), published by HD44780_Swap() */
+	char                    *Ready_Frame;     /* Last published frame, not taken by the flush engine yet */
+	char                    *Flush_Frame;     /* Snapshot the flush engine sends from, producers never write it */
+	volatile bool           Frame_Ready;      /* Ready_Frame is newer than Flush_Frame */
+#endif
+	uint8_t                 Stale_Rows;       /* Rows whose DDRAM content Text doesn't know (warm restart), one bit per row */
 	HD44780_State           State;
+	bool                    Needs_Reinit;   /* Writes are dropped until the display answers again */
+	uint32_t                Error_Tick;     /* HAL_GetTick() of the last failure or re-init attempt */
 	LCD1602_State           PowerState;
-} HD44780_HandleTypeDef;
+	HD44780_Exec_Mode       Exec_Mode;
+	HD44780_Wait_Mode       Wait_Mode;
+	uint16_t                Exec_Time_us;   /* Most instructions, HD44780_T_EXEC_US by default */
+	uint16_t                Clear_Time_us;  /* Clear display/return home, HD44780_T_CLEAR_US by default */
+#if (HD44780_FRAME_BUFFERS > 0)
+	HD44780_ScrollTypeDef   Scroll[HD44780_MAX_ROWS];
+	bool                    Scroll_Hardware; /* Rows are scrolled together with the display shift instruction */
+	bool                    Scroll_Paused;
+	uint8_t                 Scroll_Shift;    /* Display shift applied so far, 0 = return home not needed */
+	HD44780_CanvasTypeDef   *Canvas;       /* Canvas held in DDRAM and moved with the display shift, NULL = none */
+	uint16_t                Canvas_Column;   /* Canvas column loaded at DDRAM column 0 */
+#endif
+	const HD44780_GlyphTypeDef *Glyph_Slot[HD44780_GLYPH_SLOTS]; /* Glyph owning each CGRAM slot, NULL = free */
+	uint16_t                Glyph_Used[HD44780_GLYPH_SLOTS];     /* Glyph_Clock at last use, for LRU eviction */
+	uint16_t                Glyph_Clock;
+	uint8_t                 Glyph_Pending;   /* Slots assigned but not uploaded yet, one bit per slot */
+#if (HD44780_USE_STATS == 1)
+	HD44780_StatsTypeDef    Stats;
+#endif
+#if (HD44780_TRACE_DEPTH > 0)
+	HD44780_TraceTypeDef    Trace[HD44780_TRACE_DEPTH];
+	uint16_t                Trace_Head;      /* Next record written, overwrites the oldest when full */
+	uint16_t                Trace_Count;
+#endif
+#if (HD44780_POST_DEPTH > 0)
+	HD44780_PostTypeDef     Post[HD44780_POST_DEPTH];
+	volatile uint8_t        Post_Head;      /* Next free entry, written by HD44780_Post_Char() */
+	volatile uint8_t        Post_Tail;      /* Oldest entry, drained by HD44780_Process() */
+	volatile uint8_t        Post_Count;
+	volatile uint16_t       Post_Dropped;   /* Writes lost to a full ring */
+#if (HD44780_POST_OVERFLOW == HD44780_POST_COALESCE)
+	uint8_t                 Post_Slot[HD44780_NUM_ELEMENTS]; /* Entry + 1 holding each cell's waiting write, 0 = none */
+#endif
+#endif
+#if (HD44780_USE_ASYNC == 1)
+	HD44780_FrameTypeDef    Queue[HD44780_QUEUE_DEPTH];
+	volatile uint8_t        Queue_Head;     /* Oldest frame, in flight while Queue_Active is set */
+	volatile uint8_t        Queue_Tail;
+	volatile uint8_t        Queue_Count;
+	volatile bool           Queue_Active;   /* DMA/IT transfer in progress */
+	volatile bool           Queue_Waiting;  /* Holding off for a long execution time */
+	volatile uint32_t       Queue_Timestamp;
+	volatile uint16_t       Queue_Delay_us;
+	bool                    Async_Enabled;  /* Set once HD44780_Init() finishes the software reset, PCF8574 only */
+#endif
+};
 
 
 /* ####################### Startup Functions ############################### */
 bool HD44780_Init(I2C_HandleTypeDef *I2C_Handle, HD44780_HandleTypeDef *Display_Handle);
+bool HD44780_Init_Display(I2C_HandleTypeDef *I2C_Handle, HD44780_HandleTypeDef *Display_Handle, uint16_t Address, uint8_t Rows, uint8_t Cols);
+bool HD44780_Init_Transport(HD44780_HandleTypeDef *Display_Handle, const HD44780_TransportTypeDef *Transport, const void *Config, uint8_t Rows, uint8_t Cols);
+
+/* ####################### Transport Backends ############################### */
+extern const HD44780_TransportTypeDef HD44780_Transport_I2C;    /* PCF8574 backpack, used by HD44780_Init_Display() */
+extern const HD44780_TransportTypeDef HD44780_Transport_GPIO;   /* 4-bit parallel, HD44780_GPIO_ConfigTypeDef */
+#if defined(HAL_SPI_MODULE_ENABLED)
+extern const HD44780_TransportTypeDef HD44780_Transport_HC595;  /* 74HC595 shift register, HD44780_HC595_ConfigTypeDef */
+#endif
 
 /* ####################### Writing Functions ############################### */
-void HD44780_Print(HD44780_HandleTypeDef *Display_Handle, const char *str);
+HD44780_State HD44780_Print(HD44780_HandleTypeDef *Display_Handle, const char *str);
 
 /* ####################### Command Functions ############################### */
-void HD44780_Transmit_Command(HD44780_HandleTypeDef *Display_Handle, HD44780_User_Command_List UserCommand);
-void HD44780_Set_Cursor_Position(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column);
-void HD44780_Animate_Text(HD44780_HandleTypeDef *Display_Handle, uint8_t NumberOfScrolls);
+HD44780_State HD44780_Transmit_Command(HD44780_HandleTypeDef *Display_Handle, HD44780_User_Command_List UserCommand);
+HD44780_State HD44780_Set_Cursor_Position(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column);
+HD44780_State HD44780_Transmit_Address(HD44780_HandleTypeDef *Display_Handle, const uint8_t *Stream);
+HD44780_State HD44780_Animate_Text(HD44780_HandleTypeDef *Display_Handle, uint8_t NumberOfScrolls);
 
 /* ####################### Read Functions ############################### */
 char HD44780_Read_Character(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column);
 uint8_t HD44780_Get_Row_Index(HD44780_HandleTypeDef *Display_Handle);
 uint8_t HD44780_Get_Column_Index(HD44780_HandleTypeDef *Display_Handle);
+bool HD44780_Verify_Cursor_Position(HD44780_HandleTypeDef *Display_Handle);
+bool HD44780_Read_Row(HD44780_HandleTypeDef *Display_Handle, uint8_t row, char *Buffer);
+#if (HD44780_USE_SHADOW == 1)
+uint8_t HD44780_Scrub(HD44780_HandleTypeDef *Display_Handle);
+#endif
+
+/* ####################### Configuration Functions ############################### */
+void HD44780_Set_Execution_Mode(HD44780_HandleTypeDef *Display_Handle, HD44780_Exec_Mode Mode);
+void HD44780_Set_Wait_Mode(HD44780_HandleTypeDef *Display_Handle, HD44780_Wait_Mode Mode);
+bool HD44780_Calibrate(HD44780_HandleTypeDef *Display_Handle);
+
+/* ####################### Instrumentation Functions ############################### */
+uint32_t HD44780_Get_Timestamp(void);
+#if (HD44780_USE_STATS == 1)
+void HD44780_Reset_Stats(HD44780_HandleTypeDef *Display_Handle);
+#endif
+#if (HD44780_TRACE_DEPTH > 0)
+bool HD44780_Trace_Read(HD44780_HandleTypeDef *Display_Handle, HD44780_TraceTypeDef *Record);
+#endif
+
+#if (HD44780_FRAME_BUFFERS > 0)
+/* ####################### Framebuffer Functions ############################### */
+void HD44780_Frame_Clear(HD44780_HandleTypeDef *Display_Handle);
+void HD44780_Frame_Write(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column, const char *str);
+HD44780_State HD44780_Flush(HD44780_HandleTypeDef *Display_Handle);
+void HD44780_Swap(HD44780_HandleTypeDef *Display_Handle);
+void HD44780_Flush_Cost(HD44780_HandleTypeDef *Display_Handle, HD44780_CostTypeDef *Cost);
+void HD44780_Frame_Printf(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column, const char *format, ...);
+void HD44780_Frame_Glyph(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column, const HD44780_GlyphTypeDef *Glyph);
+
+/* ####################### Canvas Functions ############################### */
+void HD44780_Canvas_Init(HD44780_CanvasTypeDef *Canvas, char *Buffer, uint8_t Rows, uint16_t Width);
+void HD44780_Canvas_Write(HD44780_CanvasTypeDef *Canvas, uint8_t row, uint16_t column, const char *str);
+HD44780_State HD44780_Canvas_View(HD44780_HandleTypeDef *Display_Handle, HD44780_CanvasTypeDef *Canvas, uint16_t row, uint16_t column);
+
+/* ####################### Field Functions ############################### */
+void HD44780_Field_Init(HD44780_FieldTypeDef *Field, uint8_t row, uint8_t column, uint8_t Width, HD44780_Field_Format Format, uint8_t Decimals);
+void HD44780_Field_Set(HD44780_HandleTypeDef *Display_Handle, HD44780_FieldTypeDef *Field, int32_t Value);
+
+/* ####################### Scroll Functions ############################### */
+HD44780_State HD44780_Scroll_Start(HD44780_HandleTypeDef *Display_Handle, uint8_t row, const char *str, HD44780_Scroll_Direction Direction, uint16_t Period_ms);
+HD44780_State HD44780_Scroll_Stop(HD44780_HandleTypeDef *Display_Handle, uint8_t row);
+void HD44780_Scroll_Pause(HD44780_HandleTypeDef *Display_Handle, bool Pause);
+#endif /* HD44780_FRAME_BUFFERS */
+
+/* ####################### Glyph Functions ############################### */
+char HD44780_Glyph(HD44780_HandleTypeDef *Display_Handle, const HD44780_GlyphTypeDef *Glyph);
+
+/* ####################### Processing Functions ############################### */
+HD44780_State HD44780_Process(HD44780_HandleTypeDef *Display_Handle);
+
+/* ####################### Posting Functions ############################### */
+#if (HD44780_POST_DEPTH > 0)
+bool HD44780_Post_Char(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column, char Character);
+uint8_t HD44780_Post_Text(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t column, const char *str);
+#endif
+
+/* ####################### Asynchronous Functions ############################### */
+#if (HD44780_USE_ASYNC == 1)
+void HD44780_I2C_TxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HD44780_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+void HD44780_TxCpltCallback(HD44780_HandleTypeDef *Display_Handle);
+#endif
+
 
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* INC_HD44780_H_ */
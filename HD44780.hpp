@@ -0,0 +1,144 @@
+/*
+ * HD44780.hpp
+ *
+ *	Header-only C++17 front-end of the HD44780 driver. HD44780<Rows, Cols, Address, Transport> fixes
+ *	the geometry, the PCF8574 address and the transport at compile time: row offsets, buffer sizes
+ *	and the set DDRAM address instructions of constant positions are resolved by the compiler, so
+ *	displays of different sizes in one image share the C core without HD44780_NUM_ROWS/_COLS.
+ *	HD44780_MAX_ROWS and HD44780_MAX_COLS must still cover the largest display, e.g. built with
+ *	-DHD44780_MAX_ROWS=4 -DHD44780_MAX_COLS=20 for HD44780<4, 20>, the C core included.
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+#ifndef INC_HD44780_HPP_
+#define INC_HD44780_HPP_
+
+/* ####################### INCLUDES ############################# */
+#include "HD44780.h"
+#include <stdint.h>
+
+/* ####################### Stream ############################### */
+/* Port bytes of one instruction, see HD44780_NIBBLE_STREAM() */
+struct HD44780_Stream {
+	uint8_t                 Bytes[HD44780_COMMAND_FRAME_LEN];
+};
+
+/* ####################### Class Template ############################### */
+template <uint8_t Rows, uint8_t Cols, uint16_t Address = HW061_I2C_ADDR, const HD44780_TransportTypeDef &Transport = HD44780_Transport_I2C>
+class HD44780 {
+public:
+	static_assert((Rows >= 1) && (Rows <= 4), "The HD44780 drives 1 to 4 rows");
+	static_assert((Rows <= HD44780_MAX_ROWS) && (Cols <= HD44780_MAX_COLS), "Raise HD44780_MAX_ROWS/HD44780_MAX_COLS (HD44780.h or -D), they size the handle buffers");
+	static_assert((Cols >= 1) && ((Rows * Cols) <= 80), "DDRAM holds 80 characters");
+	static_assert((Rows <= 2) || ((2 * Cols) <= 40), "Rows 2/3 continue the 40 character lines of rows 0/1");
+
+	/* Geometry */
+	static constexpr uint8_t  Num_Rows = Rows;
+	static constexpr uint8_t  Num_Cols = Cols;
+	static constexpr uint16_t Num_Elements = (Rows * Cols);
+	static constexpr uint8_t  Line_Length = HD44780_LINE_LEN(Rows);
+	static constexpr uint16_t I2C_Address = Address;
+
+	/* Timing (HD44780 pg. 24 Table 6) */
+	static constexpr uint32_t Exec_Time_us = HD44780_T_EXEC_US;
+	static constexpr uint32_t Clear_Time_us = HD44780_T_CLEAR_US;
+	static constexpr uint32_t Byte_Time_us = HD44780_BYTE_TIME_US;
+
+	/**
+	  * @brief 	DDRAM address of column 0 of a row, see HD44780_ROW_OFFSET().
+	  * @param 	Row index (0-indexed).
+	  */
+	static constexpr uint8_t Row_Offset(uint8_t row)
+	{
+		return (Rows == 1) ? 0x00 : (uint8_t)HD44780_ROW_OFFSET(row, Cols);
+	}
+
+	/**
+	  * @brief 	DDRAM address of a cell.
+	  * @param 	Row index (0-indexed).
+	  * @param 	Column index (0-indexed).
+	  */
+	static constexpr uint8_t Address_Of(uint8_t row, uint8_t column)
+	{
+		return (uint8_t)(Row_Offset(row) + column);
+	}
+
+	/**
+	  * @brief 	Compile time version of HD44780_Encode_Nibbles().
+	  * @param 	Byte to encode.
+	  * @param 	Port bits kept constant for the whole byte (RS, RW, backlight).
+	  */
+	static constexpr HD44780_Stream Encode(uint8_t Value, uint8_t ControlBits)
+	{
+		return HD44780_Stream{ { HD44780_NIBBLE_STREAM(Value, ControlBits) } };
+	}
+
+	/**
+	  * @brief  Meant for end-user. Initializes a PCF8574 display at Address, see HD44780_Init_Display().
+	  * @param  Pointer to HAL I2C_HandleTypeDef
+	  * @retval Boolean indicating if initialization was successful.
+	  */
+	bool Init(I2C_HandleTypeDef *I2C_Handle)
+	{
+		static_assert(&Transport == &HD44780_Transport_I2C, "Other transports take their configuration, use Init(Config)");
+		return HD44780_Init_Display(I2C_Handle, &Display_Handle, Address, Rows, Cols);
+	}
+
+	/**
+	  * @brief  Meant for end-user. Initializes a display on another transport, see HD44780_Init_Transport().
+	  * @param  Backend configuration (HD44780_GPIO_ConfigTypeDef, ...), must stay valid.
+	  * @retval Boolean indicating if initialization was successful.
+	  */
+	bool Init(const void *Config)
+	{
+		return HD44780_Init_Transport(&Display_Handle, &Transport, Config, Rows, Cols);
+	}
+
+	/**
+	  * @brief  Meant for end-user. Moves the cursor to a position checked at compile time. The set
+	  * 		DDRAM address instruction is encoded by the compiler and sent from flash.
+	  */
+	template <uint8_t Row, uint8_t Column>
+	HD44780_State Set_Cursor()
+	{
+		static_assert((Row < Rows) && (Column < Cols), "Cursor position is off the display");
+		static constexpr HD44780_Stream Stream = Encode((uint8_t)(0x80 | Address_Of(Row, Column)), HD44780_BACKLIGHT);
+		return HD44780_Transmit_Address(&Display_Handle, Stream.Bytes);
+	}
+
+	/**
+	  * @brief  Meant for end-user. Prints at a position checked at compile time, see HD44780_Print().
+	  * @param  String to print.
+	  */
+	template <uint8_t Row, uint8_t Column>
+	HD44780_State Print_At(const char *str)
+	{
+		Set_Cursor<Row, Column>();
+		return HD44780_Print(&Display_Handle, str);
+	}
+
+	/* Run time positions and the rest of the C API, see HD44780.h */
+	HD44780_State Set_Cursor(uint8_t row, uint8_t column) { return HD44780_Set_Cursor_Position(&Display_Handle, row, column); }
+	HD44780_State Print(const char *str) { return HD44780_Print(&Display_Handle, str); }
+	HD44780_State Command(HD44780_User_Command_List UserCommand) { return HD44780_Transmit_Command(&Display_Handle, UserCommand); }
+	HD44780_State Process() { return HD44780_Process(&Display_Handle); }
+#if (HD44780_FRAME_BUFFERS > 0)
+	void Frame_Clear() { HD44780_Frame_Clear(&Display_Handle); }
+	void Frame_Write(uint8_t row, uint8_t column, const char *str) { HD44780_Frame_Write(&Display_Handle, row, column, str); }
+	template <typename... Args>
+	void Frame_Printf(uint8_t row, uint8_t column, const char *format, Args... args) { HD44780_Frame_Printf(&Display_Handle, row, column, format, args...); }
+	HD44780_State Flush() { return HD44780_Flush(&Display_Handle); }
+	void Swap() { HD44780_Swap(&Display_Handle); }
+	HD44780_State Canvas_View(HD44780_CanvasTypeDef *Canvas, uint16_t row, uint16_t column) { return HD44780_Canvas_View(&Display_Handle, Canvas, row, column); }
+#endif
+	HD44780_State State() const { return Display_Handle.State; }
+	HD44780_HandleTypeDef *Handle() { return &Display_Handle; }
+
+private:
+	HD44780_HandleTypeDef   Display_Handle;
+};
+
+
+#endif /* INC_HD44780_HPP_ */
@@ -0,0 +1,297 @@
+/*
+ * HD44780_RTOS.c
+ *
+ *	CMSIS-RTOS2 port of the HD44780 driver. The display task is the only caller of the driver for
+ *	its handle; HD44780_RTOS_Print_At() and friends only copy the request into a message queue.
+ *	Requests that pile up while the bus is busy are merged into one back buffer and sent with a
+ *	single HD44780_Flush(), so a burst of updates costs one diff instead of one transfer each.
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+/* ####################### Includes ############################# */
+#include "HD44780.h"
+
+#if (HD44780_USE_RTOS == 1)
+#include "HD44780_RTOS.h"
+#include <string.h>
+
+#if (HD44780_FRAME_BUFFERS == 0)
+#error "The display task merges requests in the back buffer, set HD44780_FRAME_BUFFERS 1 or 3"
+#endif
+
+/* ###################### Private variables ######################### */
+#if (HD44780_USE_ASYNC == 1)
+static HD44780_RTOS_TypeDef *RTOS_Ports[HD44780_RTOS_MAX_PORTS];
+#endif
+
+/* ###################### Private function prototypes ######################### */
+static void HD44780_RTOS_Task(void *Argument);
+static void HD44780_RTOS_Apply(HD44780_RTOS_TypeDef *Port, const HD44780_RequestTypeDef *Request);
+static bool HD44780_RTOS_Put(HD44780_RTOS_TypeDef *Port, const HD44780_RequestTypeDef *Request, uint32_t Timeout);
+static uint32_t HD44780_RTOS_Ticks(uint32_t Milliseconds);
+
+
+/* ##### Public Functions ##### */
+
+/**
+  * @brief  Meant for end-user. Creates the request queue and the display task for an initialized
+  * 		handle. From here on only the display task may call the driver for Display_Handle.
+  * @param  Pointer to HD44780_RTOS_TypeDef struct that lives as long as the task.
+  * @param  Pointer to HD44780_HandleTypeDef already set up with HD44780_Init_Display().
+  * @retval True if the queue, semaphore and task were all created.
+  */
+bool HD44780_RTOS_Start(HD44780_RTOS_TypeDef *Port, HD44780_HandleTypeDef *Display_Handle)
+{
+	const osThreadAttr_t Thread_Attributes = {
+		.name = "HD44780",
+		.stack_size = HD44780_RTOS_STACK_SIZE,
+		.priority = HD44780_RTOS_PRIORITY
+	};
+
+	memset(Port, 0, sizeof(*Port));
+	Port->Display_Handle = Display_Handle;
+
+	Port->Queue = osMessageQueueNew(HD44780_RTOS_QUEUE_DEPTH, sizeof(HD44780_RequestTypeDef), NULL);
+	Port->Done = osSemaphoreNew(1, 0, NULL);
+
+	if ((Port->Queue == NULL) || (Port->Done == NULL)) {
+		return false;
+	}
+
+#if (HD44780_USE_ASYNC == 1)
+	for (uint8_t i = 0; i < HD44780_RTOS_MAX_PORTS; i++) {
+		if (RTOS_Ports[i] == NULL) {
+			RTOS_Ports[i] = Port;
+			break;
+		}
+	}
+#endif
+
+	Port->Thread = osThreadNew(HD44780_RTOS_Task, Port, &Thread_Attributes);
+
+	return Port->Thread != NULL;
+}
+
+/**
+  * @brief  Meant for end-user. Queues text for row/column; the display task writes it into the back
+  * 		buffer. Text longer than HD44780_RTOS_TEXT_LEN is cut. Safe from ISRs with Timeout 0.
+  * @param  Pointer to HD44780_RTOS_TypeDef struct passed to HD44780_RTOS_Start().
+  * @param  Row index (0 = top)
+  * @param  Column index (0 = left)
+  * @param  Null terminated string.
+  * @param  Kernel ticks to wait for room in the queue, 0 to fail at once.
+  * @retval True if the request was queued.
+  */
+bool HD44780_RTOS_Print_At(HD44780_RTOS_TypeDef *Port, uint8_t row, uint8_t column, const char *str, uint32_t Timeout)
+{
+	HD44780_RequestTypeDef Request = { .Type = HD44780_REQUEST_TEXT, .Row = row, .Column = column };
+
+	strncpy(Request.Text, str, HD44780_RTOS_TEXT_LEN);
+	Request.Text[HD44780_RTOS_TEXT_LEN] = '\0';
+
+	return HD44780_RTOS_Put(Port, &Request, Timeout);
+}
+
+/**
+  * @brief  Meant for end-user. Queues a cursor move, applied after the queued text is on the display.
+  * @param  Pointer to HD44780_RTOS_TypeDef struct passed to HD44780_RTOS_Start().
+  * @param  Row index (0 = top)
+  * @param  Column index (0 = left)
+  * @param  Kernel ticks to wait for room in the queue, 0 to fail at once.
+  * @retval True if the request was queued.
+  */
+bool HD44780_RTOS_Set_Cursor(HD44780_RTOS_TypeDef *Port, uint8_t row, uint8_t column, uint32_t Timeout)
+{
+	const HD44780_RequestTypeDef Request = { .Type = HD44780_REQUEST_CURSOR, .Row = row, .Column = column };
+
+	return HD44780_RTOS_Put(Port, &Request, Timeout);
+}
+
+/**
+  * @brief  Meant for end-user. Queues a HD44780_Transmit_Command() for the display task.
+  * 		CLEAR_DISPLAY and RETURN_HOME are folded into the frame instead of being sent raw, unless
+  * 		a hardware scroll or canvas view has shifted the display.
+  * @param  Pointer to HD44780_RTOS_TypeDef struct passed to HD44780_RTOS_Start().
+  * @param  Command from HD44780_User_Command_List.
+  * @param  Kernel ticks to wait for room in the queue, 0 to fail at once.
+  * @retval True if the request was queued.
+  */
+bool HD44780_RTOS_Command(HD44780_RTOS_TypeDef *Port, HD44780_User_Command_List UserCommand, uint32_t Timeout)
+{
+	const HD44780_RequestTypeDef Request = { .Type = HD44780_REQUEST_COMMAND, .Command = UserCommand };
+
+	return HD44780_RTOS_Put(Port, &Request, Timeout);
+}
+
+/**
+  * @brief  Meant for end-user. Queues a blank frame. Only the cells that were showing text are sent.
+  * @param  Pointer to HD44780_RTOS_TypeDef struct passed to HD44780_RTOS_Start().
+  * @param  Kernel ticks to wait for room in the queue, 0 to fail at once.
+  * @retval True if the request was queued.
+  */
+bool HD44780_RTOS_Clear(HD44780_RTOS_TypeDef *Port, uint32_t Timeout)
+{
+	const HD44780_RequestTypeDef Request = { .Type = HD44780_REQUEST_CLEAR };
+
+	return HD44780_RTOS_Put(Port, &Request, Timeout);
+}
+
+/**
+  * @brief  Called by the driver for waits of 1ms and longer. Sleeps the calling task once the
+  * 		kernel runs, falls back to HAL_Delay() before osKernelStart().
+  * @param  Milliseconds to wait
+  */
+void HD44780_RTOS_Delay_ms(uint32_t Milliseconds)
+{
+	if (osKernelGetState() == osKernelRunning) {
+		osDelay(HD44780_RTOS_Ticks(Milliseconds));
+	}
+
+	else {
+		HAL_Delay(Milliseconds);
+	}
+}
+
+#if (HD44780_USE_ASYNC == 1)
+/**
+  * @brief  Overrides the weak driver callback: wakes the display task waiting on the transmit queue.
+  * @param  Pointer to HD44780_HandleTypeDef struct whose queue drained.
+  */
+void HD44780_TxCpltCallback(HD44780_HandleTypeDef *Display_Handle)
+{
+	for (uint8_t i = 0; i < HD44780_RTOS_MAX_PORTS; i++) {
+		if ((RTOS_Ports[i] != NULL) && (RTOS_Ports[i]->Display_Handle == Display_Handle)) {
+			osSemaphoreRelease(RTOS_Ports[i]->Done);
+			return;
+		}
+	}
+}
+#endif
+
+
+/* ##### Private Functions ##### */
+
+/**
+  * @brief  Display task. Blocks on the queue, takes every request already waiting, then sends the
+  * 		merged frame once. Runs HD44780_Process() at least every HD44780_RTOS_IDLE_MS for scrolling,
+  * 		posted cells and health checks.
+  * @param  Pointer to HD44780_RTOS_TypeDef struct passed to HD44780_RTOS_Start().
+  */
+static void HD44780_RTOS_Task(void *Argument)
+{
+	HD44780_RTOS_TypeDef *Port = (HD44780_RTOS_TypeDef *)Argument;
+	HD44780_HandleTypeDef *Display_Handle = Port->Display_Handle;
+	HD44780_RequestTypeDef Request;
+
+	for (;;) {
+		if (osMessageQueueGet(Port->Queue, &Request, NULL, HD44780_RTOS_Ticks(HD44780_RTOS_IDLE_MS)) == osOK) {
+			do {
+				HD44780_RTOS_Apply(Port, &Request);
+				Port->Requests++;
+			} while (osMessageQueueGet(Port->Queue, &Request, NULL, 0) == osOK);
+
+			HD44780_Flush(Display_Handle);
+			Port->Flushes++;
+
+			if (Port->Cursor_Pending) {
+				HD44780_Set_Cursor_Position(Display_Handle, Port->Cursor_Row, Port->Cursor_Column);
+				Port->Cursor_Pending = false;
+			}
+		}
+
+		HD44780_Process(Display_Handle);
+
+#if (HD44780_USE_ASYNC == 1)
+		/* Sleep while DMA drains the queue; the tick timeout keeps clear/home delays and faults moving */
+		while (Display_Handle->State == HD44780_BUSY) {
+			osSemaphoreAcquire(Port->Done, 1);
+			HD44780_Process(Display_Handle);
+		}
+#endif
+	}
+}
+
+/**
+  * @brief  Applies one request to the handle. Text and clears only touch the back buffer, clear
+  * 		display and return home are sent as well while the display is shifted.
+  * @param  Pointer to HD44780_RTOS_TypeDef struct.
+  * @param  Request taken from the queue.
+  */
+static void HD44780_RTOS_Apply(HD44780_RTOS_TypeDef *Port, const HD44780_RequestTypeDef *Request)
+{
+	HD44780_HandleTypeDef *Display_Handle = Port->Display_Handle;
+
+	switch (Request->Type) {
+		case HD44780_REQUEST_TEXT:
+			HD44780_Frame_Write(Display_Handle, Request->Row, Request->Column, Request->Text);
+			break;
+
+		case HD44780_REQUEST_CURSOR:
+			Port->Cursor_Row = Request->Row;
+			Port->Cursor_Column = Request->Column;
+			Port->Cursor_Pending = true;
+			break;
+
+		case HD44780_REQUEST_CLEAR:
+			HD44780_Frame_Clear(Display_Handle);
+			break;
+
+		case HD44780_REQUEST_COMMAND:
+			if (((Request->Command == CLEAR_DISPLAY) || (Request->Command == RETURN_HOME)) && Display_Handle->Scroll_Hardware) {
+				HD44780_Transmit_Command(Display_Handle, Request->Command);
+			} /* Undoes the display shift, the driver lets go of the rows and canvas it moved */
+
+			if (Request->Command == CLEAR_DISPLAY) {
+				HD44780_Frame_Clear(Display_Handle);
+				Port->Cursor_Row = 0;
+				Port->Cursor_Column = 0;
+				Port->Cursor_Pending = true;
+			}
+
+			else if (Request->Command == RETURN_HOME) {
+				Port->Cursor_Row = 0;
+				Port->Cursor_Column = 0;
+				Port->Cursor_Pending = true;
+			}
+
+			else {
+				HD44780_Transmit_Command(Display_Handle, Request->Command);
+			} /* Register writes are shadowed, repeats cost nothing */
+			break;
+
+		default:
+			break;
+	}
+}
+
+/**
+  * @brief  Copies a request into the queue.
+  * @param  Pointer to HD44780_RTOS_TypeDef struct.
+  * @param  Request to queue.
+  * @param  Kernel ticks to wait for room, must be 0 from an ISR.
+  * @retval True if the request was queued.
+  */
+static bool HD44780_RTOS_Put(HD44780_RTOS_TypeDef *Port, const HD44780_RequestTypeDef *Request, uint32_t Timeout)
+{
+	if (Port->Queue == NULL) {
+		return false;
+	}
+
+	return osMessageQueuePut(Port->Queue, Request, 0, Timeout) == osOK;
+}
+
+/**
+  * @brief  Converts milliseconds to kernel ticks, rounded up so a wait is never cut short. One tick
+  * 		more on top: osDelay() counts the tick already in progress, so n ticks can end just after
+  * 		n - 1 full periods.
+  * @param  Milliseconds
+  * @retval Kernel ticks, at least 1.
+  */
+static uint32_t HD44780_RTOS_Ticks(uint32_t Milliseconds)
+{
+	return (uint32_t)((((uint64_t)Milliseconds * osKernelGetTickFreq() + 999U) / 1000U) + 1U);
+}
+
+#endif /* HD44780_USE_RTOS */
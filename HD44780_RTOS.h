@@ -0,0 +1,78 @@
+/*
+ * HD44780_RTOS.h
+ *
+ *	CMSIS-RTOS2 port of the HD44780 driver. One display task owns the handle, other tasks (and ISRs)
+ *	send it draw requests through a message queue instead of calling the driver themselves.
+ *	Needs HD44780_USE_RTOS 1 in HD44780.h.
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+#ifndef INC_HD44780_RTOS_H_
+#define INC_HD44780_RTOS_H_
+
+/* ####################### INCLUDES ############################# */
+#include "HD44780.h"
+#include "cmsis_os2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ####################### USER DEFINES ############################### */
+#define HD44780_RTOS_QUEUE_DEPTH        16   /* Requests waiting for the display task */
+#define HD44780_RTOS_TEXT_LEN           HD44780_MAX_COLS /* Characters carried by one text request */
+#define HD44780_RTOS_STACK_SIZE         512  /* Display task, bytes */
+#define HD44780_RTOS_PRIORITY           osPriorityBelowNormal
+#define HD44780_RTOS_IDLE_MS            10   /* Longest sleep between HD44780_Process() calls while idle */
+#define HD44780_RTOS_MAX_PORTS          HD44780_MAX_DISPLAYS
+
+/* ####################### Enums ############################### */
+typedef enum {
+	HD44780_REQUEST_TEXT,       /* Text at Row/Column, written into the back buffer */
+	HD44780_REQUEST_CURSOR,     /* Cursor to Row/Column once the frame is on the glass */
+	HD44780_REQUEST_COMMAND,    /* HD44780_Transmit_Command() */
+	HD44780_REQUEST_CLEAR       /* Blank back buffer */
+} HD44780_Request_Type;
+
+/* ####################### Structs ############################### */
+typedef struct {
+	HD44780_Request_Type    Type;
+	uint8_t                 Row;
+	uint8_t                 Column;
+	HD44780_User_Command_List Command;
+	char                    Text[HD44780_RTOS_TEXT_LEN + 1];
+} HD44780_RequestTypeDef;
+
+typedef struct {
+	HD44780_HandleTypeDef   *Display_Handle; /* Only touched by the display task once started */
+	osMessageQueueId_t      Queue;
+	osSemaphoreId_t         Done;            /* Released when the transmit queue drains (HD44780_USE_ASYNC) */
+	osThreadId_t            Thread;
+	bool                    Cursor_Pending;
+	uint8_t                 Cursor_Row;
+	uint8_t                 Cursor_Column;
+	uint32_t                Requests;        /* Requests taken from the queue */
+	uint32_t                Flushes;         /* HD44780_Flush() calls, Requests - Flushes were merged */
+} HD44780_RTOS_TypeDef;
+
+
+/* ####################### Startup Functions ############################### */
+bool HD44780_RTOS_Start(HD44780_RTOS_TypeDef *Port, HD44780_HandleTypeDef *Display_Handle);
+
+/* ####################### Request Functions ############################### */
+bool HD44780_RTOS_Print_At(HD44780_RTOS_TypeDef *Port, uint8_t row, uint8_t column, const char *str, uint32_t Timeout);
+bool HD44780_RTOS_Set_Cursor(HD44780_RTOS_TypeDef *Port, uint8_t row, uint8_t column, uint32_t Timeout);
+bool HD44780_RTOS_Command(HD44780_RTOS_TypeDef *Port, HD44780_User_Command_List UserCommand, uint32_t Timeout);
+bool HD44780_RTOS_Clear(HD44780_RTOS_TypeDef *Port, uint32_t Timeout);
+
+/* ####################### Driver Hooks ############################### */
+void HD44780_RTOS_Delay_ms(uint32_t Milliseconds);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_HD44780_RTOS_H_ */
@@ -0,0 +1,381 @@
+/*
+ * HD44780_Bench.c
+ *
+ *	On-target benchmark of the HD44780 driver. Every operation is timed twice with the DWT cycle
+ *	counter: when the driver call returns and when the HD44780 is done, i.e. the transmit queue has
+ *	drained. Both are the same for blocking builds. Execution modes and single/burst writes are
+ *	selected at run time, HD44780_USE_ASYNC and HD44780_I2C_CLOCK_HZ are build options and are
+ *	repeated in every line, so the output of several builds can be concatenated and compared.
+ *
+ *	Output (SWO, ITM port 0), one CSV line per result after a '#' header line:
+ *	test,exec,write,async,i2c_hz,n,min_us,avg_us,max_us,call_us,per_s
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+/* ####################### Includes ############################# */
+#include "HD44780_Bench.h"
+#include <stdio.h>
+
+/* ###################### Private variables ######################### */
+static const char *const HD44780_Bench_Exec_Names[] = { "busy_flag", "timed", "timed_verify" }; /* HD44780_Exec_Mode order */
+
+/* ###################### Private function prototypes ######################### */
+static void HD44780_Bench_Start_Counter(void);
+static uint32_t HD44780_Bench_Cycles(void);
+static bool HD44780_Bench_Settle(HD44780_HandleTypeDef *Display_Handle);
+static void HD44780_Bench_Begin(HD44780_Bench_ResultTypeDef *Result, uint32_t Units);
+static void HD44780_Bench_Stop(HD44780_Bench_ResultTypeDef *Result, HD44780_HandleTypeDef *Display_Handle, uint32_t Start);
+static void HD44780_Bench_Report(const char *Test, HD44780_HandleTypeDef *Display_Handle, const char *Write, const HD44780_Bench_ResultTypeDef *Result);
+static void HD44780_Bench_Send(const char *Line);
+static uint32_t HD44780_Bench_Tenths_us(uint64_t Cycles);
+static void HD44780_Bench_Pattern(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t Phase, char *Line);
+static void HD44780_Bench_Print(HD44780_HandleTypeDef *Display_Handle, bool Burst);
+static void HD44780_Bench_Full_Refresh(HD44780_HandleTypeDef *Display_Handle);
+static void HD44780_Bench_Cell_Refresh(HD44780_HandleTypeDef *Display_Handle);
+static void HD44780_Bench_Set_Cursor(HD44780_HandleTypeDef *Display_Handle);
+
+
+/* ##### Public Functions ##### */
+
+/**
+  * @brief  Meant for end-user. Runs the whole benchmark on a display wired to I2C_Handle and prints
+  * 		the results over SWO. Call it once from main() after the CubeMX init functions. Brings the
+  * 		bus to HD44780_I2C_CLOCK_HZ first, so one define selects both the clock and the driver's
+  * 		bus timing. Takes a few seconds at 100kHz.
+  * @param  Pointer to HAL I2C_HandleTypeDef of the display's bus.
+  * @param  Pointer to HD44780_HandleTypeDef struct, initialized by the benchmark itself.
+  * @retval False if the bus couldn't be set up or HD44780_Init() failed.
+  */
+bool HD44780_Bench_Run(I2C_HandleTypeDef *I2C_Handle, HD44780_HandleTypeDef *Display_Handle)
+{
+	char Line[HD44780_BENCH_LINE_LEN];
+	HD44780_Bench_ResultTypeDef Result;
+	bool Initialized = true;
+
+	HD44780_Bench_Start_Counter();
+
+	if (I2C_Handle->Init.ClockSpeed != HD44780_I2C_CLOCK_HZ) {
+		I2C_Handle->Init.ClockSpeed = HD44780_I2C_CLOCK_HZ;
+		if ((HAL_I2C_DeInit(I2C_Handle) != HAL_OK) || (HAL_I2C_Init(I2C_Handle) != HAL_OK)) {
+			return false;
+		}
+	} /* Faster than HD44780_I2C_CLOCK_HZ would cut the waits the driver leaves to bus time */
+
+	snprintf(Line, sizeof(Line), "# HD44780_BENCH v%u core_hz=%lu rows=%u cols=%u async=%u i2c_hz=%lu frame_buffers=%u\n",
+			HD44780_BENCH_FORMAT_VERSION, (unsigned long)SystemCoreClock, HD44780_NUM_ROWS, HD44780_NUM_COLS,
+			HD44780_USE_ASYNC, (unsigned long)HD44780_I2C_CLOCK_HZ, HD44780_FRAME_BUFFERS);
+	HD44780_Bench_Send(Line);
+	HD44780_Bench_Send("test,exec,write,async,i2c_hz,n,min_us,avg_us,max_us,call_us,per_s\n");
+
+	HD44780_Bench_Begin(&Result, 1);
+	for (uint8_t i = 0; i < HD44780_BENCH_INIT_REPEAT; i++) {
+		const uint32_t Start = HD44780_Bench_Cycles();
+		Initialized &= HD44780_Init(I2C_Handle, Display_Handle);
+		HD44780_Bench_Stop(&Result, Display_Handle, Start);
+	} /* Max is the cold start, later calls may take the warm restart path */
+
+	if (!Initialized) {
+		HD44780_Bench_Send("# HD44780_BENCH init failed\n");
+		return false;
+	}
+	HD44780_Bench_Report("init", Display_Handle, "-", &Result);
+
+	for (uint8_t Mode = HD44780_EXEC_BUSY_FLAG; Mode <= HD44780_EXEC_TIMED_VERIFY; Mode++) {
+		HD44780_Set_Execution_Mode(Display_Handle, (HD44780_Exec_Mode)Mode);
+		if (Display_Handle->Exec_Mode != Mode) {
+			continue;
+		} /* Write-only transport, busy flag modes fall back to timed */
+
+		HD44780_Bench_Print(Display_Handle, false);
+#if (HD44780_FRAME_BUFFERS > 0)
+		HD44780_Bench_Print(Display_Handle, true);
+#endif
+		HD44780_Bench_Full_Refresh(Display_Handle);
+		HD44780_Bench_Cell_Refresh(Display_Handle);
+		HD44780_Bench_Set_Cursor(Display_Handle);
+	}
+
+	HD44780_Set_Execution_Mode(Display_Handle, HD44780_DEFAULT_EXEC_MODE);
+	HD44780_Bench_Send("# HD44780_BENCH end\n");
+
+	return true;
+}
+
+
+/* ##### Private Functions ##### */
+
+/**
+  * @brief 	Enables the DWT cycle counter. HD44780_DELAY_DWT already does, the other delay backends don't.
+  */
+static void HD44780_Bench_Start_Counter(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+  * @brief 	Reads the DWT cycle counter. It wraps after 2^32 cycles (~60s at 72MHz), far longer than
+  * 		any timed operation, and unsigned subtraction handles the wrap.
+  * @retval Core clock cycles.
+  */
+static uint32_t HD44780_Bench_Cycles(void)
+{
+	return DWT->CYCCNT;
+}
+
+/**
+  * @brief 	Runs HD44780_Process() until the transmit queue has drained. Returns at once in blocking
+  * 		builds, where every call already waited for the HD44780.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @retval False if the queue was still busy after HD44780_BENCH_SETTLE_MS.
+  */
+static bool HD44780_Bench_Settle(HD44780_HandleTypeDef *Display_Handle)
+{
+	const uint32_t Start = HAL_GetTick();
+
+	while (HD44780_Process(Display_Handle) == HD44780_BUSY) {
+		if ((HAL_GetTick() - Start) >= HD44780_BENCH_SETTLE_MS) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+  * @brief 	Clears a result before its first operation.
+  * @param 	Result to clear.
+  * @param 	Characters (or operations) one timed operation stands for.
+  */
+static void HD44780_Bench_Begin(HD44780_Bench_ResultTypeDef *Result, uint32_t Units)
+{
+	memset(Result, 0, sizeof(*Result));
+	Result->Units = Units;
+	Result->Min = UINT32_MAX;
+}
+
+/**
+  * @brief 	Ends one timed operation started at Start: notes when the driver call returned, waits for
+  * 		the transmit queue and adds both times to the result.
+  * @param 	Result to add to.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	HD44780_Bench_Cycles() before the operation.
+  */
+static void HD44780_Bench_Stop(HD44780_Bench_ResultTypeDef *Result, HD44780_HandleTypeDef *Display_Handle, uint32_t Start)
+{
+	const uint32_t Call = (HD44780_Bench_Cycles() - Start);
+	HD44780_Bench_Settle(Display_Handle);
+	const uint32_t Done = (HD44780_Bench_Cycles() - Start);
+
+	Result->Count++;
+	Result->Total += Done;
+	Result->Call_Total += Call;
+	if (Done < Result->Min) {
+		Result->Min = Done;
+	}
+
+	if (Done > Result->Max) {
+		Result->Max = Done;
+	}
+}
+
+/**
+  * @brief 	Prints one CSV line. Times are in microseconds with one decimal, per_s is characters per
+  * 		second for the print tests and operations per second for the others.
+  * @param 	Test name.
+  * @param 	Pointer to HD44780_HandleTypeDef struct, gives the execution mode.
+  * @param 	Write pattern, "-" if the test has only one.
+  * @param 	Result to print.
+  */
+static void HD44780_Bench_Report(const char *Test, HD44780_HandleTypeDef *Display_Handle, const char *Write, const HD44780_Bench_ResultTypeDef *Result)
+{
+	char Line[HD44780_BENCH_LINE_LEN];
+
+	if ((Result->Count == 0) || (Result->Total == 0)) {
+		return;
+	}
+
+	const uint32_t Min = HD44780_Bench_Tenths_us(Result->Min);
+	const uint32_t Avg = HD44780_Bench_Tenths_us(Result->Total / Result->Count);
+	const uint32_t Max = HD44780_Bench_Tenths_us(Result->Max);
+	const uint32_t Call = HD44780_Bench_Tenths_us(Result->Call_Total / Result->Count);
+	const uint32_t Rate = (uint32_t)(((uint64_t)Result->Units * Result->Count * SystemCoreClock) / Result->Total);
+
+	snprintf(Line, sizeof(Line), "%s,%s,%s,%u,%lu,%lu,%lu.%lu,%lu.%lu,%lu.%lu,%lu.%lu,%lu\n",
+			Test, HD44780_Bench_Exec_Names[Display_Handle->Exec_Mode], Write, HD44780_USE_ASYNC,
+			(unsigned long)HD44780_I2C_CLOCK_HZ, (unsigned long)Result->Count,
+			(unsigned long)(Min / 10), (unsigned long)(Min % 10), (unsigned long)(Avg / 10), (unsigned long)(Avg % 10),
+			(unsigned long)(Max / 10), (unsigned long)(Max % 10), (unsigned long)(Call / 10), (unsigned long)(Call % 10),
+			(unsigned long)Rate);
+	HD44780_Bench_Send(Line);
+}
+
+/**
+  * @brief 	Writes a line to ITM stimulus port 0. ITM_SendChar() drops the characters when no
+  * 		debugger has enabled tracing, so the benchmark also runs without a probe.
+  * @param 	Null terminated string.
+  */
+static void HD44780_Bench_Send(const char *Line)
+{
+	while (*Line != '\0') {
+		ITM_SendChar((uint32_t)*Line++);
+	}
+}
+
+/**
+  * @brief 	Converts DWT cycles to tenths of a microsecond.
+  * @param 	Core clock cycles.
+  * @retval Tenths of a microsecond.
+  */
+static uint32_t HD44780_Bench_Tenths_us(uint64_t Cycles)
+{
+	return (uint32_t)((Cycles * 10U) / (SystemCoreClock / 1000000U));
+}
+
+/**
+  * @brief 	Fills one row of text that differs from the other phase in every cell, so neither the
+  * 		shadow nor the flush planner can skip a character.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	Row index, shifts the pattern so rows differ too.
+  * @param 	0 or 1.
+  * @param 	Receives Cols characters and the terminator.
+  */
+static void HD44780_Bench_Pattern(HD44780_HandleTypeDef *Display_Handle, uint8_t row, uint8_t Phase, char *Line)
+{
+	for (uint8_t i = 0; i < Display_Handle->Cols; i++) {
+		Line[i] = (char)(((Phase != 0) ? 'a' : 'A') + ((row + i) % 26));
+	}
+	Line[Display_Handle->Cols] = '\0';
+}
+
+/**
+  * @brief 	Character throughput over a full row. Single is HD44780_Print(), which sends every
+  * 		character as its own transfer (merged in the transmit queue with HD44780_USE_ASYNC). Burst
+  * 		is HD44780_Frame_Write() and HD44780_Flush(), which send a run of characters in one
+  * 		transfer and skip the repeated RS setup byte where the execution mode allows. The cursor is
+  * 		moved back outside the timed part.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  * @param 	True for the flush path, needs HD44780_FRAME_BUFFERS > 0.
+  */
+static void HD44780_Bench_Print(HD44780_HandleTypeDef *Display_Handle, bool Burst)
+{
+	char Line[HD44780_MAX_COLS + 1];
+	HD44780_Bench_ResultTypeDef Result;
+
+	HD44780_Bench_Begin(&Result, Display_Handle->Cols);
+	for (uint8_t n = 0; n < HD44780_BENCH_REPEAT; n++) {
+		HD44780_Bench_Pattern(Display_Handle, 0, (n & 1), Line);
+		HD44780_Set_Cursor_Position(Display_Handle, 0, 0);
+		HD44780_Bench_Settle(Display_Handle);
+
+		const uint32_t Start = HD44780_Bench_Cycles();
+#if (HD44780_FRAME_BUFFERS > 0)
+		if (Burst) {
+			HD44780_Frame_Write(Display_Handle, 0, 0, Line);
+			HD44780_Flush(Display_Handle);
+		}
+
+		else {
+			HD44780_Print(Display_Handle, Line);
+		}
+#else
+		HD44780_Print(Display_Handle, Line);
+#endif
+		HD44780_Bench_Stop(&Result, Display_Handle, Start);
+	}
+
+	HD44780_Bench_Report("print", Display_Handle, (Burst ? "burst" : "single"), &Result);
+}
+
+/**
+  * @brief 	Latency of redrawing every cell, from the application's update to the last character on
+  * 		the glass. With a framebuffer this is HD44780_Frame_Write() of every row and HD44780_Flush(),
+  * 		without one HD44780_Set_Cursor_Position() and HD44780_Print() per row.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Bench_Full_Refresh(HD44780_HandleTypeDef *Display_Handle)
+{
+	char Line[HD44780_MAX_COLS + 1];
+	HD44780_Bench_ResultTypeDef Result;
+
+#if (HD44780_FRAME_BUFFERS > 0)
+	HD44780_Frame_Clear(Display_Handle);
+	HD44780_Flush(Display_Handle);
+	HD44780_Bench_Settle(Display_Handle);
+#endif
+
+	HD44780_Bench_Begin(&Result, 1);
+	for (uint8_t n = 0; n < HD44780_BENCH_REPEAT; n++) {
+		const uint32_t Start = HD44780_Bench_Cycles();
+		for (uint8_t row = 0; row < Display_Handle->Rows; row++) {
+			HD44780_Bench_Pattern(Display_Handle, row, (n & 1), Line);
+#if (HD44780_FRAME_BUFFERS > 0)
+			HD44780_Frame_Write(Display_Handle, row, 0, Line);
+#else
+			HD44780_Set_Cursor_Position(Display_Handle, row, 0);
+			HD44780_Print(Display_Handle, Line);
+#endif
+		}
+#if (HD44780_FRAME_BUFFERS > 0)
+		HD44780_Flush(Display_Handle);
+#endif
+		HD44780_Bench_Stop(&Result, Display_Handle, Start);
+	}
+
+	HD44780_Bench_Report("full_refresh", Display_Handle, ((HD44780_FRAME_BUFFERS > 0) ? "frame" : "print"), &Result);
+}
+
+/**
+  * @brief 	Latency of changing one cell, the bottom right one, the way a status indicator would.
+  * 		Framebuffer builds go through HD44780_Flush(), which sends the set DDRAM address and the
+  * 		character only.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Bench_Cell_Refresh(HD44780_HandleTypeDef *Display_Handle)
+{
+	const uint8_t row = (uint8_t)(Display_Handle->Rows - 1);
+	const uint8_t column = (uint8_t)(Display_Handle->Cols - 1);
+	char Character[2] = { 0, 0 };
+	HD44780_Bench_ResultTypeDef Result;
+
+	HD44780_Bench_Begin(&Result, 1);
+	for (uint8_t n = 0; n < HD44780_BENCH_REPEAT; n++) {
+		Character[0] = ((n & 1) != 0) ? '*' : '+';
+
+		const uint32_t Start = HD44780_Bench_Cycles();
+#if (HD44780_FRAME_BUFFERS > 0)
+		HD44780_Frame_Write(Display_Handle, row, column, Character);
+		HD44780_Flush(Display_Handle);
+#else
+		HD44780_Set_Cursor_Position(Display_Handle, row, column);
+		HD44780_Print(Display_Handle, Character);
+#endif
+		HD44780_Bench_Stop(&Result, Display_Handle, Start);
+	}
+
+	HD44780_Bench_Report("cell_refresh", Display_Handle, ((HD44780_FRAME_BUFFERS > 0) ? "frame" : "print"), &Result);
+}
+
+/**
+  * @brief 	Cost of HD44780_Set_Cursor_Position(). Alternates between the first and the last cell so
+  * 		the cursor really moves on every call.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Bench_Set_Cursor(HD44780_HandleTypeDef *Display_Handle)
+{
+	HD44780_Bench_ResultTypeDef Result;
+
+	HD44780_Bench_Begin(&Result, 1);
+	for (uint8_t n = 0; n < HD44780_BENCH_REPEAT; n++) {
+		const uint8_t row = ((n & 1) != 0) ? (uint8_t)(Display_Handle->Rows - 1) : 0;
+		const uint8_t column = ((n & 1) != 0) ? (uint8_t)(Display_Handle->Cols - 1) : 0;
+
+		const uint32_t Start = HD44780_Bench_Cycles();
+		HD44780_Set_Cursor_Position(Display_Handle, row, column);
+		HD44780_Bench_Stop(&Result, Display_Handle, Start);
+	}
+
+	HD44780_Bench_Report("set_cursor", Display_Handle, "-", &Result);
+}
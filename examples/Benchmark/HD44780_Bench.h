@@ -0,0 +1,51 @@
+/*
+ * HD44780_Bench.h
+ *
+ *	On-target benchmark of the HD44780 driver for STM32F1. Times init, HD44780_Print() throughput,
+ *	full screen and single cell refresh and HD44780_Set_Cursor_Position() with the DWT cycle counter
+ *	and prints one CSV line per result over SWO (ITM stimulus port 0).
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+#ifndef INC_HD44780_BENCH_H_
+#define INC_HD44780_BENCH_H_
+
+/* ####################### INCLUDES ############################# */
+#include "HD44780.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ####################### USER DEFINES ############################### */
+#define HD44780_BENCH_REPEAT            32   /* Timed operations per result line */
+#define HD44780_BENCH_INIT_REPEAT       4    /* HD44780_Init() calls, the first one is a cold start */
+#define HD44780_BENCH_SETTLE_MS         100  /* Longest wait for the transmit queue to drain after one operation */
+#define HD44780_BENCH_LINE_LEN          128  /* Longest SWO line */
+
+/* ####################### DRIVER DEFINES ############################### */
+#define HD44780_BENCH_FORMAT_VERSION    1    /* Raised when the columns change */
+
+/* ####################### Structs ############################### */
+/* One result line, times in DWT cycles */
+typedef struct {
+	uint32_t                Count;          /* Operations timed */
+	uint32_t                Units;          /* Characters (or operations) per operation, for the rate column */
+	uint32_t                Min;            /* Until the HD44780 is done, shortest operation */
+	uint32_t                Max;
+	uint64_t                Total;
+	uint64_t                Call_Total;     /* Until the driver call returned. Lower than Total with HD44780_USE_ASYNC */
+} HD44780_Bench_ResultTypeDef;
+
+
+/* ####################### Benchmark Functions ############################### */
+bool HD44780_Bench_Run(I2C_HandleTypeDef *I2C_Handle, HD44780_HandleTypeDef *Display_Handle);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_HD44780_BENCH_H_ */
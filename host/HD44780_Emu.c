@@ -0,0 +1,382 @@
+/*
+ * HD44780_Emu.c
+ *
+ *	The HD44780 latches D7..D4 on the falling edge of EN. After power on it is in 8-bit mode and
+ *	every latch is an instruction with D3..D0 LOW; function set with DL = 0 switches to 4-bit mode
+ *	where latches pair up, upper nibble first, for writes and reads alike (pg. 22, pg. 46).
+ *	A violation is counted and the instruction still executed, so one bug doesn't hide the next.
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+#include "HD44780_Emu.h"
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+/* ####################### DRIVER DEFINES ############################### */
+/* PCF8574 port bits */
+#define HD44780_EMU_RS              (1U << 0)
+#define HD44780_EMU_RW              (1U << 1)
+#define HD44780_EMU_EN              (1U << 2)
+#define HD44780_EMU_DATA            0xF0U
+
+#define HD44780_EMU_TWO_LINES(Emu)  (((Emu)->Function & 0x08U) != 0U) /* N */
+#define HD44780_EMU_LINE_LEN(Emu)   (HD44780_EMU_TWO_LINES(Emu) ? 40U : 80U)
+
+/* ##### Timing ##### */
+/**
+  * @brief 	Counts a broken timing rule.
+  * @param 	Pointer to the model.
+  * @param 	Time of the offending port byte.
+  * @param 	printf style description.
+  */
+static void HD44780_Emu_Violation(HD44780_EmuTypeDef *Emu, uint64_t Time_ns, const char *Format, ...)
+{
+	char Text[HD44780_EMU_MESSAGE_LEN - 24];
+	va_list Args;
+
+	va_start(Args, Format);
+	vsnprintf(Text, sizeof(Text), Format, Args);
+	va_end(Args);
+
+	Emu->Violations++;
+	snprintf(Emu->Last_Violation, sizeof(Emu->Last_Violation), "%.1fus: %s", (double)Time_ns / 1000.0, Text);
+	if (Emu->Verbose) {
+		fprintf(stderr, "HD44780_Emu: %s\n", Emu->Last_Violation);
+	}
+}
+
+/**
+  * @brief 	Execution time of an instruction, scaled by Exec_Scale_Pct.
+  * @param 	Pointer to the model.
+  * @param 	Instruction, ignored for data.
+  * @param 	True for a data write or read.
+  * @retval Nanoseconds.
+  */
+static uint64_t HD44780_Emu_Exec_ns(HD44780_EmuTypeDef *Emu, uint8_t Command, bool Data)
+{
+	uint64_t Time_ns = HD44780_EMU_T_EXEC_NS;
+
+	if (!Data && (Command <= 0x03U)) {
+		Time_ns = HD44780_EMU_T_CLEAR_NS;
+	} /* Clear display, return home */
+
+	else if (!Data && !Emu->Four_Bit && ((Command & 0xF0U) == 0x30U) && (Emu->Reset_Step <= 2U)) {
+		Time_ns = (Emu->Reset_Step == 1U) ? HD44780_EMU_T_INIT_1_NS : HD44780_EMU_T_INIT_2_NS;
+	} /* Software reset (pg. 46 Figure 24), Reset_Step already counts this one */
+
+	return ((Time_ns * Emu->Exec_Scale_Pct) / 100U);
+}
+
+/* ##### Address counter ##### */
+/**
+  * @brief 	Moves the address counter by one in the I/D direction, wrapping at the end of the DDRAM
+  * 		line (0x27 to 0x40, 0x67 to 0x00 in 2-line mode) or of CGRAM.
+  * @param 	Pointer to the model.
+  * @param 	True to move right.
+  */
+static void HD44780_Emu_Step_AC(HD44780_EmuTypeDef *Emu, bool Increment)
+{
+	if (Emu->AC_CGRAM) {
+		Emu->AC = (uint8_t)((Emu->AC + (Increment ? 1U : 63U)) & 0x3FU);
+	}
+
+	else if (HD44780_EMU_TWO_LINES(Emu)) {
+		if (Increment) {
+			Emu->AC = (Emu->AC == 0x27U) ? 0x40U : ((Emu->AC == 0x67U) ? 0x00U : (uint8_t)(Emu->AC + 1U));
+		}
+
+		else {
+			Emu->AC = (Emu->AC == 0x40U) ? 0x27U : ((Emu->AC == 0x00U) ? 0x67U : (uint8_t)(Emu->AC - 1U));
+		}
+	}
+
+	else {
+		Emu->AC = (uint8_t)((Emu->AC + (Increment ? 1U : 79U)) % 80U);
+	}
+}
+
+/**
+  * @brief 	Shifts the display one column, left moves the text left.
+  * @param 	Pointer to the model.
+  * @param 	True to shift left.
+  */
+static void HD44780_Emu_Shift(HD44780_EmuTypeDef *Emu, bool Left)
+{
+	const uint8_t Length = (uint8_t)HD44780_EMU_LINE_LEN(Emu);
+
+	Emu->Shift = (uint8_t)((Emu->Shift + (Left ? 1U : (Length - 1U))) % Length);
+}
+
+/* ##### Instructions ##### */
+/**
+  * @brief 	Executes an instruction or data write (pg. 24 Table 6) and starts its execution time.
+  * @param 	Pointer to the model.
+  * @param 	Instruction or character.
+  * @param 	True for RS = 1.
+  * @param 	Time of the latching EN edge.
+  */
+static void HD44780_Emu_Execute(HD44780_EmuTypeDef *Emu, uint8_t Value, bool Data, uint64_t Time_ns)
+{
+	Emu->Instructions++;
+
+	if (Data) {
+		Emu->Data_Writes++;
+		if (Emu->AC_CGRAM) {
+			Emu->CGRAM[Emu->AC & 0x3FU] = Value;
+		}
+
+		else {
+			Emu->DDRAM[Emu->AC & 0x7FU] = Value;
+			if (Emu->Entry_Shift) {
+				HD44780_Emu_Shift(Emu, Emu->Increment);
+			}
+		}
+		HD44780_Emu_Step_AC(Emu, Emu->Increment);
+	}
+
+	else if (Value & 0x80U) {
+		Emu->AC = (uint8_t)(Value & 0x7FU);
+		Emu->AC_CGRAM = false;
+	} /* Set DDRAM address */
+
+	else if (Value & 0x40U) {
+		Emu->AC = (uint8_t)(Value & 0x3FU);
+		Emu->AC_CGRAM = true;
+	} /* Set CGRAM address */
+
+	else if (Value & 0x20U) {
+		if (!Emu->Four_Bit) {
+			Emu->Reset_Step++;
+		}
+		Emu->Function = Value;
+		Emu->Four_Bit = ((Value & 0x10U) == 0U);
+		Emu->Second_Nibble = false;
+	} /* Function set, DL = 0 selects 4-bit */
+
+	else if (Value & 0x10U) {
+		if (Value & 0x08U) {
+			HD44780_Emu_Shift(Emu, ((Value & 0x04U) == 0U));
+		}
+
+		else {
+			HD44780_Emu_Step_AC(Emu, ((Value & 0x04U) != 0U));
+		}
+	} /* Cursor or display shift */
+
+	else if (Value & 0x08U) {
+		Emu->Display_Control = Value;
+	}
+
+	else if (Value & 0x04U) {
+		Emu->Increment = ((Value & 0x02U) != 0U);
+		Emu->Entry_Shift = ((Value & 0x01U) != 0U);
+	} /* Entry mode set */
+
+	else if (Value & 0x02U) {
+		Emu->AC = 0;
+		Emu->AC_CGRAM = false;
+		Emu->Shift = 0;
+	} /* Return home */
+
+	else if (Value & 0x01U) {
+		memset(Emu->DDRAM, ' ', sizeof(Emu->DDRAM));
+		Emu->AC = 0;
+		Emu->AC_CGRAM = false;
+		Emu->Shift = 0;
+		Emu->Increment = true;
+	} /* Clear display */
+
+	Emu->Busy_Until_ns = Time_ns + HD44780_Emu_Exec_ns(Emu, Value, Data);
+}
+
+/**
+  * @brief 	Falling edge of EN: latches a nibble of a write, or ends a nibble of a read.
+  * @param 	Pointer to the model.
+  * @param 	Port byte that held EN HIGH, RS, RW and D7..D4 are taken from it.
+  * @param 	Time of the edge.
+  */
+static void HD44780_Emu_Latch(HD44780_EmuTypeDef *Emu, uint8_t Held, uint64_t Time_ns)
+{
+	const bool Data = ((Held & HD44780_EMU_RS) != 0U);
+	const uint8_t Nibble = (uint8_t)(Held & HD44780_EMU_DATA);
+
+	if (Held & HD44780_EMU_RW) {
+		const bool Done = !Emu->Four_Bit || Emu->Second_Nibble;
+
+		Emu->Second_Nibble = Emu->Four_Bit && !Emu->Second_Nibble;
+		if (Done && Data) {
+			Emu->Data_Reads++;
+			HD44780_Emu_Step_AC(Emu, Emu->Increment);
+			Emu->Busy_Until_ns = Time_ns + HD44780_Emu_Exec_ns(Emu, 0, true);
+		} /* The next cell is fetched into the data register (pg. 9) */
+
+		else if (Done) {
+			Emu->Status_Reads++;
+		}
+		return;
+	}
+
+	if (Time_ns < Emu->Busy_Until_ns) {
+		HD44780_Emu_Violation(Emu, Time_ns, "%s nibble %02X written %.1fus before the previous instruction finished",
+				Data ? "data" : "instruction", Nibble, (double)(Emu->Busy_Until_ns - Time_ns) / 1000.0);
+	}
+
+	if (!Emu->Four_Bit) {
+		HD44780_Emu_Execute(Emu, Nibble, Data, Time_ns);
+	} /* D3..D0 not connected, read as LOW */
+
+	else if (!Emu->Second_Nibble) {
+		Emu->Upper_Nibble = Nibble;
+		Emu->Second_Nibble = true;
+	}
+
+	else {
+		Emu->Second_Nibble = false;
+		HD44780_Emu_Execute(Emu, (uint8_t)(Emu->Upper_Nibble | (Nibble >> 4)), Data, Time_ns);
+	}
+}
+
+/* ##### Bus callbacks ##### */
+/**
+  * @brief 	HD44780_Sim_DeviceTypeDef.Write: the PCF8574 drives a new port byte.
+  */
+static void HD44780_Emu_Port_Write(void *Context, uint8_t PortByte, uint64_t Time_ns)
+{
+	HD44780_EmuTypeDef *Emu = (HD44780_EmuTypeDef *)Context;
+	const uint8_t Previous = Emu->Port;
+	const bool Was_High = ((Previous & HD44780_EMU_EN) != 0U);
+	const bool Is_High = ((PortByte & HD44780_EMU_EN) != 0U);
+	const uint8_t Control = (HD44780_EMU_RS | HD44780_EMU_RW);
+	const uint8_t Held = (Previous & HD44780_EMU_RW) ? Control : (uint8_t)(Control | HD44780_EMU_DATA); /* Data pins are inputs on reads */
+
+	Emu->Port = PortByte;
+
+	if (!Was_High && Is_High) {
+		if (Emu->EN_Seen && ((Time_ns - Emu->EN_Rise_ns) < HD44780_EMU_T_CYCLE_E_NS)) {
+			HD44780_Emu_Violation(Emu, Time_ns, "EN cycle %lluns", (unsigned long long)(Time_ns - Emu->EN_Rise_ns));
+		}
+
+		if (((PortByte & Control) == Control) && (Time_ns < Emu->Busy_Until_ns)) {
+			HD44780_Emu_Violation(Emu, Time_ns, "DDRAM read %.1fus before the previous access finished", (double)(Emu->Busy_Until_ns - Time_ns) / 1000.0);
+		} /* The data register still holds the cell before */
+
+		if ((PortByte & HD44780_EMU_RS) && !(Previous & HD44780_EMU_RS)) {
+			HD44780_Emu_Violation(Emu, Time_ns, "RS raised with the rising edge of EN (tAS)");
+		} /* Only data accesses get a setup byte, instructions drop RS with EN rising as every PCF8574 driver does */
+		Emu->EN_Seen = true;
+		Emu->EN_Rise_ns = Time_ns;
+	}
+
+	else if (Was_High && Is_High && Emu->EN_Seen && ((PortByte & Held) != (Previous & Held))) {
+		HD44780_Emu_Violation(Emu, Time_ns, "port %02X to %02X while EN is HIGH", Previous, PortByte);
+	} /* EN was never raised by the driver before its first write after power on */
+
+	else if (Was_High && !Is_High) {
+		if (Emu->EN_Seen && ((Time_ns - Emu->EN_Rise_ns) < HD44780_EMU_T_PW_EN_NS)) {
+			HD44780_Emu_Violation(Emu, Time_ns, "EN pulse %lluns", (unsigned long long)(Time_ns - Emu->EN_Rise_ns));
+		}
+
+		if (Emu->EN_Seen && ((PortByte & Held) != (Previous & Held))) {
+			HD44780_Emu_Violation(Emu, Time_ns, "port %02X to %02X with the falling edge of EN (tH)", Previous, PortByte);
+		} /* Not for the first byte after power on, the PCF8574 starts with every pin HIGH */
+		HD44780_Emu_Latch(Emu, Previous, Time_ns);
+	}
+}
+
+/**
+  * @brief 	HD44780_Sim_DeviceTypeDef.Read: port pins for a receive. The PCF8574 reads back its
+  * 		latch ANDed with what the HD44780 drives; with EN and RW HIGH that is the current nibble
+  * 		of the busy flag and address counter, or of the data register.
+  */
+static uint8_t HD44780_Emu_Port_Read(void *Context, uint64_t Time_ns)
+{
+	HD44780_EmuTypeDef *Emu = (HD44780_EmuTypeDef *)Context;
+	const uint8_t Reading = (HD44780_EMU_RW | HD44780_EMU_EN);
+
+	if ((Emu->Port & Reading) != Reading) {
+		return Emu->Port;
+	}
+
+	uint8_t Value = 0;
+	if (Emu->Port & HD44780_EMU_RS) {
+		Value = Emu->AC_CGRAM ? Emu->CGRAM[Emu->AC & 0x3FU] : Emu->DDRAM[Emu->AC & 0x7FU];
+	}
+
+	else {
+		Value = (uint8_t)(((Time_ns < Emu->Busy_Until_ns) ? 0x80U : 0x00U) | (Emu->AC & 0x7FU));
+	}
+
+	const uint8_t Nibble = Emu->Second_Nibble ? (uint8_t)(Value << 4) : Value;
+
+	return (uint8_t)((Emu->Port & 0x0FU) | (Emu->Port & Nibble & HD44780_EMU_DATA));
+}
+
+/* ####################### Emulator Functions ############################### */
+/**
+  * @brief 	Powers the model on and connects it to the simulated bus.
+  * @param 	Pointer to the model, Exec_Scale_Pct and Verbose are kept if already set.
+  */
+void HD44780_Emu_Attach(HD44780_EmuTypeDef *Emu)
+{
+	const HD44780_Sim_DeviceTypeDef Device = {
+		.Write = HD44780_Emu_Port_Write,
+		.Read = HD44780_Emu_Port_Read,
+		.Context = Emu
+	};
+
+	HD44780_Emu_Power_On(Emu);
+	HD44780_Sim_Attach(&Device);
+}
+
+/**
+  * @brief 	Power on reset (pg. 23): 8-bit, 1 line, display off, I/D = 1, DDRAM blank, counters
+  * 		cleared. CGRAM is left as it was, it holds garbage after power on.
+  * @param 	Pointer to the model.
+  */
+void HD44780_Emu_Power_On(HD44780_EmuTypeDef *Emu)
+{
+	const uint32_t Scale = (Emu->Exec_Scale_Pct != 0U) ? Emu->Exec_Scale_Pct : 100U;
+	const bool Verbose = Emu->Verbose;
+	uint8_t CGRAM[sizeof(Emu->CGRAM)];
+
+	memcpy(CGRAM, Emu->CGRAM, sizeof(CGRAM));
+	memset(Emu, 0, sizeof(*Emu));
+	memcpy(Emu->CGRAM, CGRAM, sizeof(CGRAM));
+	memset(Emu->DDRAM, ' ', sizeof(Emu->DDRAM));
+	Emu->Increment = true;
+	Emu->Port = 0xFF; /* PCF8574 power on state */
+	Emu->Exec_Scale_Pct = Scale;
+	Emu->Verbose = Verbose;
+}
+
+/**
+  * @brief 	What a display row shows, through the display shift.
+  * @param 	Pointer to the model.
+  * @param 	Row index (0-indexed), mapped as HD44780_ROW_OFFSET.
+  * @param 	Columns of the display.
+  * @param 	Receives Cols characters and a terminator.
+  */
+void HD44780_Emu_Row(const HD44780_EmuTypeDef *Emu, uint8_t row, uint8_t Cols, char *Buffer)
+{
+	const uint8_t Length = (uint8_t)HD44780_EMU_LINE_LEN(Emu);
+	const uint8_t Base = (row & 1U) ? 0x40U : 0x00U;
+	const uint8_t First = (uint8_t)((row >> 1) * Cols); /* Rows 2 and 3 continue lines 0 and 1 */
+
+	for (uint8_t column = 0; column < Cols; column++) {
+		Buffer[column] = (char)Emu->DDRAM[Base + ((First + column + Emu->Shift) % Length)];
+	}
+	Buffer[Cols] = '\0';
+}
+
+/**
+  * @brief 	Busy flag as the driver would read it now.
+  * @param 	Pointer to the model.
+  * @retval True while an instruction executes.
+  */
+bool HD44780_Emu_Busy(const HD44780_EmuTypeDef *Emu)
+{
+	return (HD44780_Sim_Time_ns() < Emu->Busy_Until_ns);
+}
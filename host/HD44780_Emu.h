@@ -0,0 +1,79 @@
+/*
+ * HD44780_Emu.h
+ *
+ *	Behavioural model of a PCF8574 backpack and HD44780 for the host build. Decodes the port bytes
+ *	the driver sends through HD44780_Sim.c back into instructions, keeps DDRAM, CGRAM and the
+ *	address counter, answers busy flag and DDRAM reads and counts every timing rule the driver
+ *	breaks: writes while busy, EN pulse and cycle times, RS/RW or data changing while EN is HIGH.
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+#ifndef HOST_HD44780_EMU_H_
+#define HOST_HD44780_EMU_H_
+
+/* ####################### INCLUDES ############################# */
+#include "HD44780_Sim.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ####################### USER DEFINES ############################### */
+#define HD44780_EMU_MESSAGE_LEN     96  /* Last violation, for test output */
+
+/* ####################### DRIVER DEFINES ############################### */
+/* Timing (HD44780 pg. 24 Table 6 at fosc = 270kHz, pg. 45-46 and pg. 52 Table 11) */
+#define HD44780_EMU_T_EXEC_NS       37000UL
+#define HD44780_EMU_T_CLEAR_NS      1520000UL
+#define HD44780_EMU_T_INIT_1_NS     4100000UL /* First function set of the software reset */
+#define HD44780_EMU_T_INIT_2_NS     100000UL  /* Second one */
+#define HD44780_EMU_T_PW_EN_NS      450UL     /* EN HIGH */
+#define HD44780_EMU_T_CYCLE_E_NS    1000UL    /* EN rise to rise */
+
+/* ####################### Structs ############################### */
+typedef struct {
+	uint8_t                 DDRAM[128];     /* Indexed by address, 0x00-0x27 and 0x40-0x67 in 2-line mode */
+	uint8_t                 CGRAM[64];
+	uint8_t                 AC;             /* Address counter */
+	bool                    AC_CGRAM;       /* AC points into CGRAM */
+	bool                    Increment;      /* I/D */
+	bool                    Entry_Shift;    /* S, the display shifts on every data write */
+	uint8_t                 Shift;          /* Display shifted left by this many columns, modulo the line length */
+	uint8_t                 Function;       /* Last function set */
+	uint8_t                 Display_Control;
+	bool                    Four_Bit;
+	bool                    Second_Nibble;  /* Next EN latch is the lower nibble */
+	uint8_t                 Upper_Nibble;
+	uint8_t                 Reset_Step;     /* 8-bit function sets since power on */
+
+	uint8_t                 Port;           /* PCF8574 output latch */
+	bool                    EN_Seen;
+	uint64_t                EN_Rise_ns;
+	uint64_t                Busy_Until_ns;
+	uint32_t                Exec_Scale_Pct; /* Execution times in % of the datasheet, a slow oscillator is above 100 */
+
+	uint32_t                Instructions;
+	uint32_t                Data_Writes;
+	uint32_t                Data_Reads;
+	uint32_t                Status_Reads;
+	uint32_t                Violations;
+	char                    Last_Violation[HD44780_EMU_MESSAGE_LEN];
+	bool                    Verbose;        /* Print each violation to stderr as it happens */
+} HD44780_EmuTypeDef;
+
+
+/* ####################### Emulator Functions ############################### */
+void HD44780_Emu_Attach(HD44780_EmuTypeDef *Emu);
+void HD44780_Emu_Power_On(HD44780_EmuTypeDef *Emu);
+void HD44780_Emu_Row(const HD44780_EmuTypeDef *Emu, uint8_t row, uint8_t Cols, char *Buffer);
+bool HD44780_Emu_Busy(const HD44780_EmuTypeDef *Emu);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_HD44780_EMU_H_ */
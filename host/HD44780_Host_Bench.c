@@ -0,0 +1,166 @@
+/*
+ * HD44780_Host_Bench.c
+ *
+ *	Bus cost of the main driver calls on the simulated HAL: port bytes, I2C transactions and
+ *	simulated time until the HD44780 is done, per execution mode. Prints CSV and exits with 1
+ *	when a result is above its limit, so a change that makes a call slower fails the build.
+ *	After a change that makes one faster, lower its limit to the new result.
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+#include "HD44780.h"
+#include "HD44780_Sim.h"
+#include <stdio.h>
+
+/* ####################### USER DEFINES ############################### */
+#define HD44780_HOST_BENCH_TIME_SLACK_PCT   1  /* Allowed on top of a time limit, clock reads in polling loops shift it slightly */
+#define HD44780_HOST_BENCH_SCROLLS          1  /* HD44780_Animate_Text() runs, each one moves a whole line through */
+
+/* ####################### Structs ############################### */
+typedef enum {
+	HD44780_HOST_BENCH_INIT,
+	HD44780_HOST_BENCH_PRINT,       /* Full screen from (0,0) */
+	HD44780_HOST_BENCH_SET_CURSOR,  /* Every cell once */
+	HD44780_HOST_BENCH_ANIMATE
+} HD44780_Host_Bench_Test;
+
+typedef struct {
+	HD44780_Host_Bench_Test Test;
+	const char              *Name;
+	HD44780_Exec_Mode       Mode;
+	uint32_t                Max_Bytes;      /* Written and received port bytes */
+	uint32_t                Max_Transactions;
+	uint32_t                Max_Time_us;
+} HD44780_Host_Bench_LimitTypeDef;
+
+/* ####################### Variables ############################### */
+/* 16x2 at 100kHz. Init is a cold start, without a device model every busy flag read reads ready */
+static const HD44780_Host_Bench_LimitTypeDef HD44780_Host_Bench_Limits[] = {
+	{ HD44780_HOST_BENCH_INIT,       "init",       HD44780_EXEC_BUSY_FLAG,   60,  28,  52645   },
+	{ HD44780_HOST_BENCH_PRINT,      "print",      HD44780_EXEC_BUSY_FLAG,   406, 204, 59059   },
+	{ HD44780_HOST_BENCH_SET_CURSOR, "set_cursor", HD44780_EXEC_BUSY_FLAG,   352, 192, 52874   },
+	{ HD44780_HOST_BENCH_ANIMATE,    "animate",    HD44780_EXEC_BUSY_FLAG,   440, 240, 4001296 },
+	{ HD44780_HOST_BENCH_PRINT,      "print",      HD44780_EXEC_TIMED,       138, 34,  16161   },
+	{ HD44780_HOST_BENCH_SET_CURSOR, "set_cursor", HD44780_EXEC_TIMED,       128, 32,  15040   },
+	{ HD44780_HOST_BENCH_ANIMATE,    "animate",    HD44780_EXEC_TIMED,       160, 40,  4000322 },
+};
+
+static const char *const HD44780_Host_Bench_Modes[] = { "busy_flag", "timed", "timed_verify" };
+
+static I2C_HandleTypeDef hi2c1;
+static HD44780_HandleTypeDef HD44780_Handle;
+
+/* ####################### Benchmark Functions ############################### */
+/**
+  * @brief 	Waits until the transmit queue is drained. Nothing to wait for when blocking.
+  */
+static void HD44780_Host_Bench_Settle(void)
+{
+	while (HD44780_Process(&HD44780_Handle) == HD44780_BUSY) {
+		__WFI();
+	}
+}
+
+/**
+  * @brief 	Runs one test from a freshly initialised display, only the test itself is counted.
+  * @param 	Test and execution mode.
+  * @param 	Receives the cost.
+  * @retval False if the driver reported an error.
+  */
+static bool HD44780_Host_Bench_Measure(const HD44780_Host_Bench_LimitTypeDef *Limit, HD44780_Sim_CountersTypeDef *Cost)
+{
+	static const char Screen[] = "0123456789ABCDEFfedcba9876543210";
+	HD44780_Sim_CountersTypeDef Start;
+	bool Ok = true;
+
+	HD44780_Sim_Reset();
+	hi2c1.Init.ClockSpeed = HD44780_I2C_CLOCK_HZ;
+	memset(&HD44780_Handle, 0, sizeof(HD44780_Handle));
+	HD44780_Sim_Snapshot(&Start);
+	if (Limit->Test == HD44780_HOST_BENCH_INIT) {
+		Ok = HD44780_Init(&hi2c1, &HD44780_Handle);
+		HD44780_Host_Bench_Settle();
+		HD44780_Sim_Since(&Start, Cost);
+		return Ok;
+	}
+
+	Ok = HD44780_Init(&hi2c1, &HD44780_Handle);
+	HD44780_Set_Execution_Mode(&HD44780_Handle, Limit->Mode);
+	HD44780_Host_Bench_Settle();
+	if (Limit->Test == HD44780_HOST_BENCH_ANIMATE) {
+		HD44780_Print(&HD44780_Handle, "Hello");
+		HD44780_Host_Bench_Settle();
+	}
+
+	HD44780_Sim_Snapshot(&Start);
+	switch (Limit->Test) {
+	case HD44780_HOST_BENCH_PRINT:
+		HD44780_Set_Cursor_Position(&HD44780_Handle, 0, 0);
+		HD44780_Print(&HD44780_Handle, Screen);
+		break;
+
+	case HD44780_HOST_BENCH_SET_CURSOR:
+		for (uint8_t row = 0; row < HD44780_Handle.Rows; row++) {
+			for (uint8_t column = 0; column < HD44780_Handle.Cols; column++) {
+				HD44780_Set_Cursor_Position(&HD44780_Handle, row, column);
+			}
+		}
+		break;
+
+	case HD44780_HOST_BENCH_ANIMATE:
+		HD44780_Animate_Text(&HD44780_Handle, HD44780_HOST_BENCH_SCROLLS);
+		break;
+
+	default:
+		break;
+	}
+	HD44780_Host_Bench_Settle();
+	HD44780_Sim_Since(&Start, Cost);
+
+	return (Ok && (HD44780_Handle.State != HD44780_ERROR));
+}
+
+int main(void)
+{
+	bool Pass = true;
+
+	printf("# HD44780_HOST_BENCH rows=%u cols=%u async=%u i2c_hz=%u frame_buffers=%u\n",
+			(unsigned)HD44780_NUM_ROWS, (unsigned)HD44780_NUM_COLS, (unsigned)HD44780_USE_ASYNC,
+			(unsigned)HD44780_I2C_CLOCK_HZ, (unsigned)HD44780_FRAME_BUFFERS);
+	printf("test,exec,bytes,transactions,time_us,max_bytes,max_transactions,max_time_us,result\n");
+
+	for (size_t i = 0; i < (sizeof(HD44780_Host_Bench_Limits) / sizeof(HD44780_Host_Bench_Limits[0])); i++) {
+		const HD44780_Host_Bench_LimitTypeDef *Limit = &HD44780_Host_Bench_Limits[i];
+		const uint32_t Max_Time_us = (uint32_t)(((uint64_t)Limit->Max_Time_us * (100U + HD44780_HOST_BENCH_TIME_SLACK_PCT)) / 100U);
+		HD44780_Sim_CountersTypeDef Cost;
+		const char *Result = "ok";
+		bool Slower = false;
+
+		const bool Ok = HD44780_Host_Bench_Measure(Limit, &Cost);
+		const uint32_t Bytes = (Cost.Tx_Bytes + Cost.Rx_Bytes);
+		const uint32_t Time_us = (uint32_t)((Cost.Time_ns + 999U) / 1000U);
+
+		if (!Ok) {
+			Result = "error";
+		}
+
+		else if ((Bytes > Limit->Max_Bytes) || (Cost.Transactions > Limit->Max_Transactions) || (Time_us > Max_Time_us)) {
+			Result = "slower";
+			Slower = true;
+		}
+
+		else if ((Bytes < Limit->Max_Bytes) || (Cost.Transactions < Limit->Max_Transactions) || (Time_us < Limit->Max_Time_us)) {
+			Result = "faster"; /* Passes, the limit can be lowered */
+		}
+		Pass = (Pass && Ok && !Slower);
+
+		printf("%s,%s,%lu,%lu,%lu,%lu,%lu,%lu,%s\n", Limit->Name, HD44780_Host_Bench_Modes[Limit->Mode],
+				(unsigned long)Bytes, (unsigned long)Cost.Transactions, (unsigned long)Time_us,
+				(unsigned long)Limit->Max_Bytes, (unsigned long)Limit->Max_Transactions, (unsigned long)Limit->Max_Time_us, Result);
+	}
+	printf("# HD44780_HOST_BENCH %s\n", Pass ? "pass" : "FAIL");
+
+	return Pass ? 0 : 1;
+}
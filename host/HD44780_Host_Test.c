@@ -0,0 +1,782 @@
+/*
+ * HD44780_Host_Test.c
+ *
+ *	Driver tests against the emulated display: what DDRAM and CGRAM end up holding, and that no
+ *	call breaks a timing rule in any execution mode. Built once per configuration in CMakeLists.txt,
+ *	tests that need an option the configuration leaves out are skipped by the preprocessor.
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+#include "HD44780.h"
+#include "HD44780_Emu.h"
+#if (HD44780_USE_RTOS == 1)
+#include "HD44780_RTOS.h"
+#endif
+#include <stdio.h>
+
+/* ####################### DRIVER DEFINES ############################### */
+#define HD44780_TEST_CHECK(Condition) \
+	do { \
+		if (!(Condition)) { \
+			HD44780_Test_Failed = true; \
+			printf("  %s:%d: %s\n", __FILE__, __LINE__, #Condition); \
+		} \
+	} while (0)
+
+/* DDRAM row as shown, against a string of HD44780_NUM_COLS characters */
+#define HD44780_TEST_ROW(Row, Expected) \
+	do { \
+		char Shown[HD44780_MAX_COLS + 1]; \
+		HD44780_Emu_Row(&HD44780_Test_Emu, (Row), HD44780_NUM_COLS, Shown); \
+		if (strcmp(Shown, (Expected)) != 0) { \
+			HD44780_Test_Failed = true; \
+			printf("  %s:%d: row %u shows \"%s\", expected \"%s\"\n", __FILE__, __LINE__, (unsigned)(Row), Shown, (Expected)); \
+		} \
+	} while (0)
+
+#define HD44780_TEST_NO_VIOLATIONS() \
+	do { \
+		if (HD44780_Test_Emu.Violations != 0U) { \
+			HD44780_Test_Failed = true; \
+			printf("  %s:%d: %lu violations, last at %s\n", __FILE__, __LINE__, (unsigned long)HD44780_Test_Emu.Violations, HD44780_Test_Emu.Last_Violation); \
+		} \
+	} while (0)
+
+/* ####################### Structs ############################### */
+typedef struct {
+	const char              *Name;
+	void                    (*Run)(void);
+} HD44780_Test_CaseTypeDef;
+
+/* ####################### Variables ############################### */
+static I2C_HandleTypeDef hi2c1;
+static HD44780_HandleTypeDef HD44780_Handle;
+static HD44780_EmuTypeDef HD44780_Test_Emu;
+static bool HD44780_Test_Failed;
+
+static const char HD44780_Test_Blank[] = "                ";
+
+/* ####################### Helpers ############################### */
+/**
+  * @brief 	Waits until the transmit queue is drained. Nothing to wait for when blocking. Spins, a
+  * 		sleep until the next SysTick would stretch the wait after a clear display.
+  */
+static void HD44780_Test_Settle(void)
+{
+	while (HD44780_Process(&HD44780_Handle) == HD44780_BUSY) {
+		/* Each call reads the clock, so simulated time moves on */
+	}
+}
+
+/**
+  * @brief 	Runs the simulated clock and HD44780_Process() for a while, as a main loop would.
+  * @param 	Milliseconds.
+  */
+static void HD44780_Test_Run_ms(uint32_t Milliseconds)
+{
+	const uint32_t Start = HAL_GetTick();
+
+	while ((HAL_GetTick() - Start) < Milliseconds) {
+		HD44780_Process(&HD44780_Handle);
+		__WFI();
+	}
+}
+
+/**
+  * @brief 	Powers the emulated display on and initialises the driver in an execution mode.
+  * @param 	Execution mode.
+  */
+static void HD44780_Test_Start(HD44780_Exec_Mode Mode)
+{
+	HD44780_Sim_Reset();
+#if (HD44780_USE_RTOS == 1)
+	HD44780_Sim_RTOS_Reset();
+#endif
+	memset(&HD44780_Test_Emu, 0, sizeof(HD44780_Test_Emu));
+	HD44780_Emu_Attach(&HD44780_Test_Emu);
+	hi2c1.Init.ClockSpeed = HD44780_I2C_CLOCK_HZ;
+	memset(&HD44780_Handle, 0, sizeof(HD44780_Handle));
+
+	HD44780_TEST_CHECK(HD44780_Init(&hi2c1, &HD44780_Handle));
+	HD44780_Set_Execution_Mode(&HD44780_Handle, Mode);
+	HD44780_Test_Settle();
+}
+
+/* ####################### Tests ############################### */
+static void HD44780_Test_Init(void)
+{
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+
+	HD44780_TEST_CHECK(HD44780_Test_Emu.Four_Bit);
+	HD44780_TEST_CHECK((HD44780_Test_Emu.Function & HD44780_TWO_LINES) != 0U);
+	HD44780_TEST_CHECK((HD44780_Test_Emu.Display_Control & HD44780_DISPLAY_BIT) != 0U);
+	HD44780_TEST_CHECK(HD44780_Test_Emu.Increment && !HD44780_Test_Emu.Entry_Shift);
+	HD44780_TEST_CHECK(HD44780_Test_Emu.AC == 0x00U);
+	HD44780_TEST_ROW(0, HD44780_Test_Blank);
+	HD44780_TEST_ROW(1, HD44780_Test_Blank);
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Print_Modes(void)
+{
+	for (HD44780_Exec_Mode Mode = HD44780_EXEC_BUSY_FLAG; Mode <= HD44780_EXEC_TIMED_VERIFY; Mode++) {
+		HD44780_Test_Start(Mode);
+		HD44780_Set_Cursor_Position(&HD44780_Handle, 0, 0);
+		HD44780_Print(&HD44780_Handle, "0123456789ABCDEFfedcba9876543210");
+		HD44780_Test_Settle();
+
+		HD44780_TEST_ROW(0, "0123456789ABCDEF");
+		HD44780_TEST_ROW(1, "fedcba9876543210");
+		HD44780_TEST_NO_VIOLATIONS();
+	} /* Wraps onto the second row */
+}
+
+static void HD44780_Test_Set_Cursor(void)
+{
+	HD44780_Test_Start(HD44780_EXEC_TIMED);
+	HD44780_Set_Cursor_Position(&HD44780_Handle, 1, 5);
+	HD44780_Print(&HD44780_Handle, "X");
+	HD44780_Set_Cursor_Position(&HD44780_Handle, 0, 15);
+	HD44780_Print(&HD44780_Handle, "Y");
+	HD44780_Test_Settle();
+
+	HD44780_TEST_ROW(0, "               Y");
+	HD44780_TEST_ROW(1, "     X          ");
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Clear(void)
+{
+	for (HD44780_Exec_Mode Mode = HD44780_EXEC_BUSY_FLAG; Mode <= HD44780_EXEC_TIMED; Mode++) {
+		HD44780_Test_Start(Mode);
+		HD44780_Print(&HD44780_Handle, "Hello");
+		HD44780_Transmit_Command(&HD44780_Handle, CLEAR_DISPLAY);
+		HD44780_Print(&HD44780_Handle, "Hi"); /* Right after the 1.52ms clear */
+		HD44780_Test_Settle();
+
+		HD44780_TEST_ROW(0, "Hi              ");
+		HD44780_TEST_NO_VIOLATIONS();
+	}
+}
+
+static void HD44780_Test_Slow_Module(void)
+{
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+	HD44780_Test_Emu.Exec_Scale_Pct = 150;
+	HD44780_Print(&HD44780_Handle, "Slow");
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(0, "Slow            ");
+	HD44780_TEST_NO_VIOLATIONS(); /* The busy flag covers it */
+
+	HD44780_Set_Execution_Mode(&HD44780_Handle, HD44780_EXEC_TIMED);
+	HD44780_Transmit_Command(&HD44780_Handle, CLEAR_DISPLAY);
+	HD44780_Print(&HD44780_Handle, "Slow");
+	HD44780_Test_Settle();
+#if (HD44780_USE_RTOS == 0)
+	HD44780_TEST_CHECK(HD44780_Test_Emu.Violations > 0U); /* Datasheet times are too short, the model must notice */
+#endif /* The clear display wait is whole kernel ticks, enough for this module too */
+}
+
+static void HD44780_Test_Sleep(void)
+{
+	for (HD44780_Exec_Mode Mode = HD44780_EXEC_BUSY_FLAG; Mode <= HD44780_EXEC_TIMED; Mode++) {
+		HD44780_Test_Start(Mode);
+		HD44780_Set_Wait_Mode(&HD44780_Handle, HD44780_WAIT_SLEEP);
+		HD44780_Print(&HD44780_Handle, "Hello");
+		HD44780_Transmit_Command(&HD44780_Handle, CLEAR_DISPLAY); /* Slept out, at most a SysTick late */
+		HD44780_Print(&HD44780_Handle, "Hi");
+		HD44780_Test_Settle();
+
+		HD44780_TEST_ROW(0, "Hi              ");
+		HD44780_TEST_NO_VIOLATIONS();
+	}
+}
+
+static void HD44780_Test_Glyph(void)
+{
+	static const HD44780_GlyphTypeDef Bell = { { 0x04, 0x0E, 0x0E, 0x0E, 0x1F, 0x00, 0x04, 0x00 } };
+
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+	const char Code = HD44780_Glyph(&HD44780_Handle, &Bell);
+	const char Text[] = { 'A', Code, 'B', '\0' };
+	HD44780_Print(&HD44780_Handle, Text);
+	HD44780_Test_Settle();
+
+	HD44780_TEST_CHECK((Code >= HD44780_GLYPH_CODE(0)) && (Code < HD44780_GLYPH_CODE(HD44780_GLYPH_SLOTS)));
+	HD44780_TEST_CHECK(memcmp(&HD44780_Test_Emu.CGRAM[(Code & 0x07) * 8], Bell.Lines, sizeof(Bell.Lines)) == 0);
+	HD44780_TEST_CHECK((HD44780_Test_Emu.DDRAM[0] == 'A') && (HD44780_Test_Emu.DDRAM[1] == (uint8_t)Code) && (HD44780_Test_Emu.DDRAM[2] == 'B'));
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Registers(void)
+{
+	HD44780_Sim_CountersTypeDef Start;
+	HD44780_Sim_CountersTypeDef Cost;
+
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+	HD44780_Transmit_Command(&HD44780_Handle, CURSOR_BLINK);
+	HD44780_Transmit_Command(&HD44780_Handle, CURSOR_OFF);
+	HD44780_Test_Settle();
+	HD44780_TEST_CHECK((HD44780_Test_Emu.Display_Control & (HD44780_CURSOR_BIT | HD44780_BLINK_BIT)) == HD44780_BLINK_BIT);
+	HD44780_Transmit_Command(&HD44780_Handle, CURSOR_UNBLINK);
+	HD44780_Test_Settle();
+	HD44780_TEST_CHECK((HD44780_Test_Emu.Display_Control & (HD44780_DISPLAY_BIT | HD44780_CURSOR_BIT | HD44780_BLINK_BIT)) == HD44780_DISPLAY_BIT);
+
+	HD44780_Transmit_Command(&HD44780_Handle, BACKLIGHT_OFF);
+	HD44780_Print(&HD44780_Handle, "Dark");
+	HD44780_Test_Settle();
+	HD44780_TEST_CHECK((HD44780_Test_Emu.Port & HD44780_BACKLIGHT) == 0U);
+
+	HD44780_Sim_Snapshot(&Start);
+	HD44780_Transmit_Command(&HD44780_Handle, CURSOR_OFF);
+	HD44780_Transmit_Command(&HD44780_Handle, BACKLIGHT_OFF);
+	HD44780_Sim_Since(&Start, &Cost);
+	HD44780_TEST_CHECK(Cost.Transactions == 0U); /* Already set */
+	HD44780_TEST_ROW(0, "Dark            ");
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Warm_Restart(void)
+{
+	HD44780_Sim_CountersTypeDef Start;
+	HD44780_Sim_CountersTypeDef Cost;
+
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+	HD44780_Print(&HD44780_Handle, "Kept");
+	HD44780_Test_Settle();
+
+	memset(&HD44780_Handle, 0, sizeof(HD44780_Handle)); /* MCU reset, the display keeps its power */
+	HD44780_Sim_Snapshot(&Start);
+	HD44780_TEST_CHECK(HD44780_Init(&hi2c1, &HD44780_Handle));
+	HD44780_Test_Settle();
+	HD44780_Sim_Since(&Start, &Cost);
+
+	HD44780_TEST_CHECK(HD44780_Test_Emu.Four_Bit);
+	HD44780_TEST_NO_VIOLATIONS();
+#if (HD44780_WARM_RESTART == 1)
+	HD44780_TEST_ROW(0, "Kept            ");
+	HD44780_TEST_CHECK(Cost.Time_ns < (HD44780_T_POWER_ON_MS * 1000000ULL)); /* No power on wait */
+#endif
+}
+
+static void HD44780_Test_Reconnect(void)
+{
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+	HD44780_Print(&HD44780_Handle, "Before");
+	HD44780_Test_Settle();
+
+	HD44780_Sim_Set_Present(false);
+	HD44780_Print(&HD44780_Handle, " lost");
+	HD44780_Test_Settle();
+	HD44780_TEST_CHECK(HD44780_Handle.State == HD44780_ERROR);
+
+	memset(HD44780_Test_Emu.DDRAM, ' ', sizeof(HD44780_Test_Emu.DDRAM)); /* Power cycled while unplugged */
+	HD44780_Sim_Set_Present(true);
+	HD44780_Test_Run_ms(HD44780_REINIT_INTERVAL_MS + 10U);
+	HD44780_TEST_CHECK(HD44780_Handle.State == HD44780_READY);
+	HD44780_TEST_ROW(0, "Before lost     "); /* Rebuilt from Text */
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+#if (HD44780_USE_ASYNC == 0)
+static void HD44780_Test_Read_Row(void)
+{
+	char Buffer[HD44780_MAX_COLS + 1] = { 0 };
+
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+	HD44780_Set_Cursor_Position(&HD44780_Handle, 1, 0);
+	HD44780_Print(&HD44780_Handle, "Read me back   !");
+	HD44780_TEST_CHECK(HD44780_Read_Row(&HD44780_Handle, 1, Buffer));
+
+	HD44780_TEST_CHECK(memcmp(Buffer, "Read me back   !", HD44780_NUM_COLS) == 0);
+	HD44780_TEST_CHECK(HD44780_Verify_Cursor_Position(&HD44780_Handle));
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Scrub(void)
+{
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+	HD44780_Print(&HD44780_Handle, "Scrub");
+	HD44780_Test_Emu.DDRAM[1] = 'X'; /* Corrupted on the display, e.g. by a glitch on the bus */
+
+	HD44780_TEST_CHECK(HD44780_Scrub(&HD44780_Handle) == 1U);
+	HD44780_TEST_ROW(0, "Scrub           ");
+	HD44780_TEST_CHECK(HD44780_Scrub(&HD44780_Handle) == 0U); /* Row 1 */
+	HD44780_TEST_CHECK(HD44780_Verify_Cursor_Position(&HD44780_Handle));
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Calibrate(void)
+{
+	const uint32_t Clear_us = ((HD44780_EMU_T_CLEAR_NS * 150U) / 100000U); /* What the slow module needs */
+
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+	HD44780_Test_Emu.Exec_Scale_Pct = 150;
+	HD44780_TEST_CHECK(HD44780_Calibrate(&HD44780_Handle));
+	HD44780_TEST_CHECK(HD44780_Handle.Clear_Time_us >= Clear_us);
+	HD44780_TEST_CHECK(HD44780_Handle.Clear_Time_us <= (((Clear_us + 150U) * (100U + HD44780_CALIBRATE_MARGIN_PCT)) / 100U)); /* Within about one busy flag sample at 100kHz */
+
+	HD44780_Set_Execution_Mode(&HD44780_Handle, HD44780_EXEC_TIMED);
+	HD44780_Transmit_Command(&HD44780_Handle, CLEAR_DISPLAY);
+	HD44780_Print(&HD44780_Handle, "Slow");
+	HD44780_TEST_ROW(0, "Slow            ");
+	HD44780_TEST_NO_VIOLATIONS(); /* Timed at the module's own speed */
+}
+#endif
+
+static void HD44780_Test_Animate(void)
+{
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+	HD44780_Print(&HD44780_Handle, "Hello");
+	HD44780_Animate_Text(&HD44780_Handle, 1);
+	HD44780_Test_Settle();
+
+	HD44780_TEST_CHECK(HD44780_Test_Emu.Shift == 0U); /* A whole line, back where it started */
+	HD44780_TEST_ROW(0, "Hello           ");
+#if (HD44780_FRAME_BUFFERS > 0)
+	HD44780_TEST_CHECK(HD44780_Handle.Scroll[0].Text == NULL);
+#endif /* Blocking display shifts otherwise */
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+#if (HD44780_FRAME_BUFFERS > 0)
+static void HD44780_Test_Flush(void)
+{
+	HD44780_Sim_CountersTypeDef Start;
+	HD44780_Sim_CountersTypeDef Cost;
+
+	HD44780_Test_Start(HD44780_EXEC_TIMED);
+	HD44780_Frame_Write(&HD44780_Handle, 0, 0, "Frame one");
+	HD44780_Frame_Write(&HD44780_Handle, 1, 4, "below");
+	HD44780_Flush(&HD44780_Handle);
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(0, "Frame one       ");
+	HD44780_TEST_ROW(1, "    below       ");
+
+	HD44780_Frame_Write(&HD44780_Handle, 0, 6, "two");
+	HD44780_Flush(&HD44780_Handle);
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(0, "Frame two       ");
+	HD44780_TEST_ROW(1, "    below       ");
+
+	HD44780_Sim_Snapshot(&Start);
+	HD44780_Flush(&HD44780_Handle);
+	HD44780_Test_Settle();
+	HD44780_Sim_Since(&Start, &Cost);
+	HD44780_TEST_CHECK(Cost.Tx_Bytes == 0U); /* Nothing changed */
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Swap(void)
+{
+	HD44780_Sim_CountersTypeDef Start;
+	HD44780_Sim_CountersTypeDef Cost;
+
+	HD44780_Test_Start(HD44780_EXEC_TIMED);
+	HD44780_Sim_Snapshot(&Start);
+	HD44780_Frame_Write(&HD44780_Handle, 0, 0, "First");
+	HD44780_Swap(&HD44780_Handle);
+	HD44780_Frame_Write(&HD44780_Handle, 0, 0, "Sec");
+	HD44780_Swap(&HD44780_Handle);
+	HD44780_Sim_Since(&Start, &Cost);
+	HD44780_TEST_CHECK(Cost.Transactions == 0U); /* Swaps never touch the bus */
+	HD44780_TEST_ROW(0, HD44780_Test_Blank);
+
+	HD44780_Test_Run_ms(1);
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(0, "Secst           "); /* The newest frame, drawn on top of the one published before it */
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Canvas(void)
+{
+	static char Narrow_Buffer[2 * 40];
+	static char Wide_Buffer[2 * 48];
+	HD44780_CanvasTypeDef Narrow;
+	HD44780_CanvasTypeDef Wide;
+
+	HD44780_Test_Start(HD44780_EXEC_TIMED);
+	HD44780_Canvas_Init(&Narrow, Narrow_Buffer, 2, 40);
+	HD44780_Canvas_Write(&Narrow, 0, 0, "0123456789abcdefghijklmnopqrstuvwxyzABCD");
+	HD44780_Canvas_Write(&Narrow, 1, 2, "second row");
+	HD44780_Canvas_View(&HD44780_Handle, &Narrow, 0, 0);
+	HD44780_Canvas_View(&HD44780_Handle, &Narrow, 0, 5); /* Loaded into DDRAM, moved by the display shift */
+	HD44780_Test_Settle();
+	HD44780_TEST_CHECK(HD44780_Test_Emu.Shift == 5U);
+	HD44780_TEST_ROW(0, "56789abcdefghijk");
+	HD44780_TEST_ROW(1, "ond row         ");
+	HD44780_Canvas_View(&HD44780_Handle, &Narrow, 0, 60); /* Clamped to the canvas */
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(0, "opqrstuvwxyzABCD");
+
+	HD44780_Canvas_Init(&Wide, Wide_Buffer, 2, 48); /* Wider than a DDRAM line, drawn through the back buffer */
+	HD44780_Canvas_Write(&Wide, 0, 30, "beyond a DDRAM line");
+	HD44780_Canvas_View(&HD44780_Handle, &Wide, 0, 32);
+	HD44780_Test_Settle();
+	HD44780_TEST_CHECK(HD44780_Test_Emu.Shift == 0U);
+	HD44780_TEST_ROW(0, "yond a DDRAM lin");
+	HD44780_TEST_ROW(1, HD44780_Test_Blank);
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Flush_Cost(void)
+{
+	HD44780_Sim_CountersTypeDef Start;
+	HD44780_Sim_CountersTypeDef Cost;
+	HD44780_CostTypeDef Plan;
+
+	HD44780_Test_Start(HD44780_EXEC_TIMED);
+	HD44780_Frame_Write(&HD44780_Handle, 0, 0, "Left");
+	HD44780_Frame_Write(&HD44780_Handle, 0, 10, "Right");
+	HD44780_Frame_Write(&HD44780_Handle, 1, 3, "x");
+	HD44780_Flush_Cost(&HD44780_Handle, &Plan);
+
+	HD44780_Sim_Snapshot(&Start);
+	HD44780_Flush(&HD44780_Handle);
+	HD44780_Test_Settle();
+	HD44780_Sim_Since(&Start, &Cost);
+	HD44780_TEST_CHECK((Cost.Time_ns / 1000U) >= ((Plan.Time_us * 90U) / 100U));
+	HD44780_TEST_CHECK((Cost.Time_ns / 1000U) <= ((Plan.Time_us * 110U) / 100U));
+#if (HD44780_USE_ASYNC == 0)
+	HD44780_TEST_CHECK(Plan.Bus_Bytes == (Cost.Tx_Bytes + Cost.Transactions)); /* Port bytes plus one address byte per transaction */
+#endif /* The queue merges frames into fewer transactions */
+	HD44780_TEST_ROW(0, "Left      Right ");
+	HD44780_TEST_ROW(1, "   x            ");
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Printf(void)
+{
+	HD44780_FieldTypeDef Temperature;
+	HD44780_FieldTypeDef Code;
+
+	HD44780_Test_Start(HD44780_EXEC_TIMED);
+	HD44780_Frame_Printf(&HD44780_Handle, 0, 0, "%s=%-4d|%05u", "n", -12, 42U);
+	HD44780_Field_Init(&Temperature, 1, 0, 5, HD44780_FIELD_FIXED, 1);
+	HD44780_Field_Init(&Code, 1, 12, 4, HD44780_FIELD_HEX, 0);
+	HD44780_Field_Set(&HD44780_Handle, &Temperature, 215);
+	HD44780_Field_Set(&HD44780_Handle, &Code, 0xBEEF);
+	HD44780_Flush(&HD44780_Handle);
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(0, "n=-12 |00042    ");
+	HD44780_TEST_ROW(1, " 21.5       BEEF");
+
+	HD44780_Field_Set(&HD44780_Handle, &Temperature, -5);
+	HD44780_Field_Set(&HD44780_Handle, &Code, 0x12345);
+	HD44780_Flush(&HD44780_Handle);
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(1, " -0.5       ****"); /* Too wide for its field */
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Field_Clear(void)
+{
+	HD44780_FieldTypeDef Temperature;
+
+	HD44780_Test_Start(HD44780_EXEC_TIMED);
+	HD44780_Field_Init(&Temperature, 0, 0, 5, HD44780_FIELD_FIXED, 1);
+	HD44780_Field_Set(&HD44780_Handle, &Temperature, 215);
+	HD44780_Flush(&HD44780_Handle);
+	HD44780_Test_Settle();
+
+	HD44780_Frame_Clear(&HD44780_Handle);
+	HD44780_Field_Set(&HD44780_Handle, &Temperature, 215); /* Same value, the cells are blank now */
+	HD44780_Flush(&HD44780_Handle);
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(0, " 21.5           ");
+
+	HD44780_Frame_Write(&HD44780_Handle, 0, 3, "xx");
+	HD44780_Field_Set(&HD44780_Handle, &Temperature, 215);
+	HD44780_Flush(&HD44780_Handle);
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(0, " 21.5           ");
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Animate_Paused(void)
+{
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+	HD44780_Print(&HD44780_Handle, "Hello");
+	HD44780_Scroll_Pause(&HD44780_Handle, true);
+	HD44780_Animate_Text(&HD44780_Handle, 1); /* Returns, the engine is resumed */
+	HD44780_Test_Settle();
+
+	HD44780_TEST_CHECK(HD44780_Test_Emu.Shift == 0U);
+	HD44780_TEST_CHECK(HD44780_Handle.Scroll[0].Text == NULL);
+	HD44780_TEST_CHECK(!HD44780_Handle.Scroll_Paused);
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Animate_Unplugged(void)
+{
+	uint32_t Start;
+
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+	HD44780_Print(&HD44780_Handle, "Hello");
+	HD44780_Test_Settle();
+	HD44780_Sim_Set_Present(false);
+	Start = HAL_GetTick();
+	HD44780_Animate_Text(&HD44780_Handle, 1);
+
+	HD44780_TEST_CHECK((HAL_GetTick() - Start) <= (2UL * (HD44780_LINE_LEN(HD44780_NUM_ROWS) + 1UL) * HD44780_ANIMATE_PERIOD_MS));
+	HD44780_TEST_CHECK(HD44780_Handle.Scroll[0].Text == NULL); /* Not left scrolling */
+	HD44780_Sim_Set_Present(true);
+}
+
+static void HD44780_Test_Scroll(void)
+{
+	HD44780_Test_Start(HD44780_EXEC_TIMED);
+	HD44780_Frame_Write(&HD44780_Handle, 1, 0, "static");
+	HD44780_Flush(&HD44780_Handle);
+	HD44780_Scroll_Start(&HD44780_Handle, 0, "The quick brown fox jumps", HD44780_SCROLL_LEFT, 200);
+	HD44780_Test_Run_ms(20);
+	HD44780_TEST_ROW(0, "The quick brown ");
+	HD44780_TEST_ROW(1, "static          ");
+
+	HD44780_Test_Run_ms(400);
+	HD44780_TEST_ROW(0, "e quick brown fo"); /* Two steps */
+	HD44780_TEST_ROW(1, "static          ");
+
+	HD44780_Scroll_Stop(&HD44780_Handle, 0);
+	HD44780_Test_Run_ms(400);
+	HD44780_TEST_ROW(0, "e quick brown fo");
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Scroll_Home(void)
+{
+	HD44780_Test_Start(HD44780_EXEC_TIMED);
+	HD44780_Scroll_Start(&HD44780_Handle, 0, "Top", HD44780_SCROLL_LEFT, 100);
+	HD44780_Scroll_Start(&HD44780_Handle, 1, "Bottom", HD44780_SCROLL_LEFT, 100); /* Same speed, moved by the display shift */
+	HD44780_Test_Run_ms(350);
+	HD44780_TEST_CHECK(HD44780_Handle.Scroll_Hardware && (HD44780_Test_Emu.Shift != 0U));
+
+	HD44780_Scroll_Pause(&HD44780_Handle, true); /* No step before the rows are checked */
+	HD44780_Transmit_Command(&HD44780_Handle, RETURN_HOME);
+	HD44780_Test_Settle();
+	HD44780_TEST_CHECK((HD44780_Handle.Scroll_Shift == 0U) && (HD44780_Test_Emu.Shift == 0U));
+	HD44780_TEST_ROW(0, "Top             ");
+	HD44780_TEST_ROW(1, "Bottom          ");
+	HD44780_Scroll_Pause(&HD44780_Handle, false);
+	HD44780_Test_Run_ms(250);
+	HD44780_TEST_CHECK(HD44780_Test_Emu.Shift != 0U); /* Still scrolling */
+
+	HD44780_Transmit_Command(&HD44780_Handle, CLEAR_DISPLAY);
+	HD44780_Test_Run_ms(250);
+	HD44780_TEST_CHECK((HD44780_Handle.Scroll[0].Text == NULL) && (HD44780_Handle.Scroll[1].Text == NULL));
+	HD44780_TEST_CHECK(!HD44780_Handle.Scroll_Hardware && (HD44780_Test_Emu.Shift == 0U));
+	HD44780_Print(&HD44780_Handle, "After");
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(0, "After           ");
+	HD44780_TEST_ROW(1, HD44780_Test_Blank);
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_Canvas_Home(void)
+{
+	static char Buffer[2 * 40];
+	HD44780_CanvasTypeDef Canvas;
+
+	HD44780_Test_Start(HD44780_EXEC_TIMED);
+	HD44780_Canvas_Init(&Canvas, Buffer, 2, 40);
+	HD44780_Canvas_Write(&Canvas, 0, 0, "0123456789abcdefghijklmnopqrstuvwxyzABCD");
+	HD44780_Canvas_View(&HD44780_Handle, &Canvas, 0, 0);
+	HD44780_Canvas_View(&HD44780_Handle, &Canvas, 0, 5); /* Loaded into DDRAM, moved by the display shift */
+	HD44780_Test_Settle();
+	HD44780_TEST_CHECK((HD44780_Handle.Canvas == &Canvas) && (HD44780_Test_Emu.Shift == 5U));
+	HD44780_TEST_ROW(0, "56789abcdefghijk");
+
+	HD44780_Transmit_Command(&HD44780_Handle, RETURN_HOME);
+	HD44780_Test_Settle();
+	HD44780_TEST_CHECK((HD44780_Handle.Canvas == NULL) && (Canvas.View_Column == 0U));
+	HD44780_TEST_ROW(0, "0123456789abcdef");
+	HD44780_Canvas_View(&HD44780_Handle, &Canvas, 0, 5);
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(0, "56789abcdefghijk");
+
+	HD44780_Transmit_Command(&HD44780_Handle, CLEAR_DISPLAY);
+	HD44780_Test_Settle();
+	HD44780_TEST_CHECK((HD44780_Handle.Canvas == NULL) && (HD44780_Test_Emu.Shift == 0U));
+	HD44780_TEST_ROW(0, HD44780_Test_Blank);
+	HD44780_Canvas_View(&HD44780_Handle, &Canvas, 0, 5);
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(0, "56789abcdefghijk");
+	HD44780_TEST_NO_VIOLATIONS();
+}
+#endif
+
+#if (HD44780_POST_DEPTH > 0)
+static void HD44780_Test_Post(void)
+{
+	HD44780_Test_Start(HD44780_EXEC_TIMED);
+	HD44780_TEST_CHECK(HD44780_Post_Text(&HD44780_Handle, 0, 0, "Hi") == 2U);
+	HD44780_TEST_CHECK(HD44780_Post_Char(&HD44780_Handle, 0, 0, 'X')); /* Takes the waiting write's place */
+	HD44780_TEST_ROW(0, HD44780_Test_Blank); /* Nothing sent from the poster */
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(0, "Xi              ");
+
+	HD44780_TEST_CHECK(HD44780_Post_Text(&HD44780_Handle, 1, 0, "0123456789ABCDEF") == HD44780_POST_DEPTH);
+	HD44780_TEST_CHECK(HD44780_Handle.Post_Dropped == (HD44780_NUM_COLS - HD44780_POST_DEPTH));
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(1, "01234567        ");
+	HD44780_TEST_NO_VIOLATIONS();
+}
+#endif
+
+#if (HD44780_USE_ASYNC == 1)
+static void HD44780_Test_Queue(void)
+{
+	HD44780_Test_Start(HD44780_EXEC_TIMED);
+	HD44780_Print(&HD44780_Handle, "Queued text");
+	HD44780_TEST_CHECK(HD44780_Process(&HD44780_Handle) == HD44780_BUSY); /* Returned before the bus was done */
+	HD44780_Test_Settle();
+
+	HD44780_TEST_ROW(0, "Queued text     ");
+	HD44780_TEST_NO_VIOLATIONS();
+}
+#endif
+
+#if (HD44780_USE_RTOS == 1)
+static void HD44780_Test_RTOS_Merge(void)
+{
+	HD44780_RTOS_TypeDef Port;
+
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+	HD44780_TEST_CHECK(HD44780_RTOS_Start(&Port, &HD44780_Handle));
+	HD44780_TEST_CHECK(HD44780_RTOS_Print_At(&Port, 0, 0, "First", 0));
+	HD44780_TEST_CHECK(HD44780_RTOS_Set_Cursor(&Port, 1, 0, 0));
+	HD44780_TEST_CHECK(HD44780_RTOS_Print_At(&Port, 0, 0, "Second", 0));
+	HD44780_TEST_CHECK(HD44780_RTOS_Set_Cursor(&Port, 1, 3, 0));
+	HD44780_TEST_ROW(0, HD44780_Test_Blank); /* Only queued */
+
+	HD44780_Sim_RTOS_Step();
+	HD44780_Test_Settle();
+	HD44780_TEST_CHECK((Port.Requests == 4U) && (Port.Flushes == 1U));
+	HD44780_TEST_ROW(0, "Second          ");
+	HD44780_TEST_CHECK(HD44780_Test_Emu.AC == 0x43U); /* Last cursor move, after the frame */
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_RTOS_Fold(void)
+{
+	HD44780_RTOS_TypeDef Port;
+
+	HD44780_Test_Start(HD44780_EXEC_BUSY_FLAG);
+	HD44780_TEST_CHECK(HD44780_RTOS_Start(&Port, &HD44780_Handle));
+	HD44780_RTOS_Print_At(&Port, 0, 0, "Shown", 0);
+	HD44780_Sim_RTOS_Step();
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(0, "Shown           ");
+
+	HD44780_RTOS_Print_At(&Port, 1, 0, "Gone", 0);
+	HD44780_RTOS_Command(&Port, CLEAR_DISPLAY, 0); /* Blanks the frame, requests before it too */
+	HD44780_RTOS_Print_At(&Port, 1, 2, "After", 0);
+	HD44780_Sim_RTOS_Step();
+	HD44780_Test_Settle();
+	HD44780_TEST_CHECK(Port.Flushes == 2U);
+	HD44780_TEST_ROW(0, HD44780_Test_Blank);
+	HD44780_TEST_ROW(1, "  After         ");
+	HD44780_TEST_CHECK(HD44780_Test_Emu.AC == 0x00U);
+
+	HD44780_RTOS_Set_Cursor(&Port, 1, 7, 0);
+	HD44780_RTOS_Command(&Port, RETURN_HOME, 0); /* Supersedes the cursor move */
+	HD44780_Sim_RTOS_Step();
+	HD44780_Test_Settle();
+	HD44780_TEST_ROW(1, "  After         ");
+	HD44780_TEST_CHECK(HD44780_Test_Emu.AC == 0x00U);
+	HD44780_TEST_NO_VIOLATIONS();
+}
+
+static void HD44780_Test_RTOS_Home(void)
+{
+	HD44780_RTOS_TypeDef Port;
+
+	HD44780_Test_Start(HD44780_EXEC_TIMED);
+	HD44780_TEST_CHECK(HD44780_RTOS_Start(&Port, &HD44780_Handle));
+	HD44780_Scroll_Start(&HD44780_Handle, 0, "Top", HD44780_SCROLL_LEFT, 100);
+	HD44780_Scroll_Start(&HD44780_Handle, 1, "Bottom", HD44780_SCROLL_LEFT, 100);
+	HD44780_Test_Run_ms(350);
+	HD44780_TEST_CHECK(HD44780_Handle.Scroll_Hardware && (HD44780_Test_Emu.Shift != 0U));
+
+	HD44780_Scroll_Pause(&HD44780_Handle, true);
+	HD44780_RTOS_Command(&Port, RETURN_HOME, 0); /* Sent, a cursor move would leave the shift */
+	HD44780_Sim_RTOS_Step();
+	HD44780_Test_Settle();
+	HD44780_TEST_CHECK((HD44780_Handle.Scroll_Shift == 0U) && (HD44780_Test_Emu.Shift == 0U));
+	HD44780_TEST_ROW(0, "Top             ");
+	HD44780_TEST_ROW(1, "Bottom          ");
+	HD44780_Scroll_Pause(&HD44780_Handle, false);
+	HD44780_Test_Run_ms(250);
+	HD44780_TEST_CHECK(HD44780_Test_Emu.Shift != 0U); /* Still scrolling */
+
+	HD44780_RTOS_Command(&Port, CLEAR_DISPLAY, 0);
+	HD44780_Sim_RTOS_Step();
+	HD44780_Test_Run_ms(250);
+	HD44780_TEST_CHECK((HD44780_Handle.Scroll[0].Text == NULL) && (HD44780_Handle.Scroll[1].Text == NULL));
+	HD44780_TEST_CHECK(!HD44780_Handle.Scroll_Hardware && (HD44780_Test_Emu.Shift == 0U));
+	HD44780_TEST_ROW(0, HD44780_Test_Blank);
+	HD44780_TEST_ROW(1, HD44780_Test_Blank);
+	HD44780_TEST_NO_VIOLATIONS();
+}
+#endif
+
+/* ####################### Runner ############################### */
+static const HD44780_Test_CaseTypeDef HD44780_Test_Cases[] = {
+	{ "init",              HD44780_Test_Init },
+	{ "print_modes",       HD44780_Test_Print_Modes },
+	{ "set_cursor",        HD44780_Test_Set_Cursor },
+	{ "clear",             HD44780_Test_Clear },
+	{ "slow_module",       HD44780_Test_Slow_Module },
+	{ "sleep",             HD44780_Test_Sleep },
+	{ "glyph",             HD44780_Test_Glyph },
+	{ "registers",         HD44780_Test_Registers },
+	{ "warm_restart",      HD44780_Test_Warm_Restart },
+	{ "reconnect",         HD44780_Test_Reconnect },
+#if (HD44780_USE_ASYNC == 0)
+	{ "read_row",          HD44780_Test_Read_Row },
+	{ "scrub",             HD44780_Test_Scrub },
+	{ "calibrate",         HD44780_Test_Calibrate },
+#endif
+	{ "animate",           HD44780_Test_Animate },
+#if (HD44780_FRAME_BUFFERS > 0)
+	{ "flush",             HD44780_Test_Flush },
+	{ "swap",              HD44780_Test_Swap },
+	{ "canvas",            HD44780_Test_Canvas },
+	{ "flush_cost",        HD44780_Test_Flush_Cost },
+	{ "printf",            HD44780_Test_Printf },
+	{ "field_clear",       HD44780_Test_Field_Clear },
+	{ "animate_paused",    HD44780_Test_Animate_Paused },
+	{ "animate_unplugged", HD44780_Test_Animate_Unplugged },
+	{ "scroll",            HD44780_Test_Scroll },
+	{ "scroll_home",       HD44780_Test_Scroll_Home },
+	{ "canvas_home",       HD44780_Test_Canvas_Home },
+#endif
+#if (HD44780_POST_DEPTH > 0)
+	{ "post",              HD44780_Test_Post },
+#endif
+#if (HD44780_USE_ASYNC == 1)
+	{ "queue",             HD44780_Test_Queue },
+#endif
+#if (HD44780_USE_RTOS == 1)
+	{ "rtos_merge",        HD44780_Test_RTOS_Merge },
+	{ "rtos_fold",         HD44780_Test_RTOS_Fold },
+	{ "rtos_home",         HD44780_Test_RTOS_Home },
+#endif
+};
+
+int main(void)
+{
+	uint32_t Failures = 0;
+
+	for (size_t i = 0; i < (sizeof(HD44780_Test_Cases) / sizeof(HD44780_Test_Cases[0])); i++) {
+		HD44780_Test_Failed = false;
+		HD44780_Test_Cases[i].Run();
+		printf("%s %s\n", HD44780_Test_Failed ? "FAIL" : "ok  ", HD44780_Test_Cases[i].Name);
+		Failures += HD44780_Test_Failed ? 1U : 0U;
+	}
+	printf("%lu of %lu failed\n", (unsigned long)Failures, (unsigned long)(sizeof(HD44780_Test_Cases) / sizeof(HD44780_Test_Cases[0])));
+
+	return (Failures == 0U) ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+/*
+ * HD44780_Host_Test_Cpp.cpp
+ *
+ *	C++17 tests of HD44780.hpp against the emulated display: positions given as template arguments
+ *	must land where the C API puts them. Built against a driver with HD44780_MAX_ROWS/_COLS raised
+ *	with -D, so HD44780<4, 20> fits next to the 16x2 of HD44780_Init().
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+#include "HD44780.hpp"
+#include "HD44780_Emu.h"
+#include <stdio.h>
+
+/* ####################### DRIVER DEFINES ############################### */
+#define HD44780_TEST_CHECK(Condition) \
+	do { \
+		if (!(Condition)) { \
+			HD44780_Test_Failed = true; \
+			printf("  %s:%d: %s\n", __FILE__, __LINE__, #Condition); \
+		} \
+	} while (0)
+
+/* DDRAM row as shown, against a string of Cols characters */
+#define HD44780_TEST_ROW(Row, Cols, Expected) \
+	do { \
+		char Shown[HD44780_MAX_COLS + 1]; \
+		HD44780_Emu_Row(&HD44780_Test_Emu, (Row), (Cols), Shown); \
+		if (strcmp(Shown, (Expected)) != 0) { \
+			HD44780_Test_Failed = true; \
+			printf("  %s:%d: row %u shows \"%s\", expected \"%s\"\n", __FILE__, __LINE__, (unsigned)(Row), Shown, (Expected)); \
+		} \
+	} while (0)
+
+/* ####################### Structs ############################### */
+typedef struct {
+	const char              *Name;
+	void                    (*Run)(void);
+} HD44780_Test_CaseTypeDef;
+
+/* ####################### Variables ############################### */
+static I2C_HandleTypeDef hi2c1;
+static HD44780_EmuTypeDef HD44780_Test_Emu;
+static bool HD44780_Test_Failed;
+
+/* Resolved by the compiler, HD44780 pg. 11-12 */
+static_assert(HD44780<2, 16>::Address_Of(1, 5) == 0x45, "Row 1 starts at 0x40");
+static_assert(HD44780<4, 20>::Row_Offset(2) == 0x14, "Row 2 continues line 0");
+static_assert(HD44780<4, 20>::Row_Offset(3) == 0x54, "Row 3 continues line 1");
+static_assert(HD44780<1, 8>::Address_Of(0, 7) == 0x07, "One line from 0x00");
+
+/* ####################### Helpers ############################### */
+/**
+  * @brief 	Powers the emulated display on, the driver is initialised by the test.
+  */
+static void HD44780_Test_Power_On(void)
+{
+	HD44780_Sim_Reset();
+	memset(&HD44780_Test_Emu, 0, sizeof(HD44780_Test_Emu));
+	HD44780_Emu_Attach(&HD44780_Test_Emu);
+	hi2c1.Init.ClockSpeed = HD44780_I2C_CLOCK_HZ;
+}
+
+/**
+  * @brief 	Waits until the transmit queue of a handle is drained, see HD44780_Host_Test.c.
+  * @param 	Pointer to HD44780_HandleTypeDef struct.
+  */
+static void HD44780_Test_Settle(HD44780_HandleTypeDef *Display_Handle)
+{
+	while (HD44780_Process(Display_Handle) == HD44780_BUSY) {
+		/* Each call reads the clock, so simulated time moves on */
+	}
+}
+
+/* ####################### Tests ############################### */
+static void HD44780_Test_Set_Cursor(void)
+{
+	static HD44780_HandleTypeDef Display_Handle;
+	static HD44780<2, 16> Lcd;
+
+	HD44780_Test_Power_On();
+	memset(&Display_Handle, 0, sizeof(Display_Handle));
+	HD44780_TEST_CHECK(HD44780_Init_Display(&hi2c1, &Display_Handle, HW061_I2C_ADDR, 2, 16));
+	HD44780_Set_Cursor_Position(&Display_Handle, 1, 5);
+	HD44780_Print(&Display_Handle, "C");
+	HD44780_Test_Settle(&Display_Handle);
+	const uint8_t C_AC = HD44780_Test_Emu.AC;
+
+	HD44780_Test_Power_On();
+	HD44780_TEST_CHECK(Lcd.Init(&hi2c1));
+	Lcd.Set_Cursor<1, 5>();
+	Lcd.Print("C");
+	HD44780_Test_Settle(Lcd.Handle());
+
+	HD44780_TEST_ROW(0, 16, "                ");
+	HD44780_TEST_ROW(1, 16, "     C          ");
+	HD44780_TEST_CHECK(HD44780_Test_Emu.AC == C_AC);
+	HD44780_TEST_CHECK(Lcd.Handle()->Cursor_Position[0] == Display_Handle.Cursor_Position[0]);
+	HD44780_TEST_CHECK(Lcd.Handle()->Cursor_Position[1] == Display_Handle.Cursor_Position[1]);
+	HD44780_TEST_CHECK(HD44780_Test_Emu.Violations == 0U);
+}
+
+static void HD44780_Test_Wide(void)
+{
+	static HD44780<4, 20> Lcd;
+
+	HD44780_Test_Power_On();
+	HD44780_TEST_CHECK(Lcd.Init(&hi2c1));
+	Lcd.Print_At<3, 2>("Four");
+	Lcd.Print_At<2, 19>("X");
+	HD44780_Test_Settle(Lcd.Handle());
+
+	HD44780_TEST_ROW(2, 20, "                   X");
+	HD44780_TEST_ROW(3, 20, "  Four              ");
+	HD44780_TEST_CHECK(HD44780_Test_Emu.Violations == 0U);
+}
+
+/* ####################### Runner ############################### */
+static const HD44780_Test_CaseTypeDef HD44780_Test_Cases[] = {
+	{ "cpp_set_cursor", HD44780_Test_Set_Cursor },
+	{ "cpp_wide",       HD44780_Test_Wide },
+};
+
+int main(void)
+{
+	uint32_t Failures = 0;
+
+	for (size_t i = 0; i < (sizeof(HD44780_Test_Cases) / sizeof(HD44780_Test_Cases[0])); i++) {
+		HD44780_Test_Failed = false;
+		HD44780_Test_Cases[i].Run();
+		printf("%s %s\n", HD44780_Test_Failed ? "FAIL" : "ok  ", HD44780_Test_Cases[i].Name);
+		Failures += HD44780_Test_Failed ? 1U : 0U;
+	}
+	printf("%lu of %lu failed\n", (unsigned long)Failures, (unsigned long)(sizeof(HD44780_Test_Cases) / sizeof(HD44780_Test_Cases[0])));
+
+	return (Failures == 0U) ? 0 : 1;
+}
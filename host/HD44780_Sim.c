@@ -0,0 +1,493 @@
+/*
+ * HD44780_Sim.c
+ *
+ *	Host implementation of the HAL functions declared by the stub stm32f1xx_hal.h. A transaction
+ *	costs START, the address byte, 9 bit times per port byte and STOP at hi2c->Init.ClockSpeed.
+ *	DMA/IT transfers finish in the background and call HAL_I2C_MasterTxCpltCallback() once the
+ *	clock passes their STOP, as soon as PRIMASK allows.
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+#include "HD44780_Sim.h"
+#include <string.h>
+
+/* ####################### DRIVER DEFINES ############################### */
+#define HD44780_SIM_NS_PER_MS       1000000ULL
+#define HD44780_SIM_PORT_RW         (1U << 1) /* PCF8574 P1 */
+#define HD44780_SIM_PORT_EN         (1U << 2) /* PCF8574 P2 */
+
+/* ####################### Structs ############################### */
+typedef struct {
+	HD44780_Sim_CountersTypeDef Counters;
+	HD44780_Sim_DeviceTypeDef Device;
+	bool                    Has_Device;
+	bool                    Present;        /* False: every address byte is NACKed */
+	uint8_t                 Latch;          /* Port without a device model */
+
+	uint32_t                PriMask;
+	bool                    In_Interrupt;
+	bool                    Pending;        /* DMA/IT transfer on the bus */
+	bool                    Pending_Failed;
+	uint64_t                Pending_End_ns;
+	I2C_HandleTypeDef       *Pending_Handle;
+
+	HD44780_Sim_TransactionTypeDef Log[HD44780_SIM_LOG_DEPTH];
+	uint32_t                Log_Count;      /* Since HD44780_Sim_Reset(), the ring keeps the last HD44780_SIM_LOG_DEPTH */
+
+	DWT_Type                Dwt;
+	SysTick_Type            Systick;
+} HD44780_Sim_StateTypeDef;
+
+/* ####################### Variables ############################### */
+uint32_t SystemCoreClock = HD44780_SIM_CORE_HZ;
+CoreDebug_Type HD44780_Sim_CoreDebug;
+
+static HD44780_Sim_StateTypeDef Sim = {
+	.Present = true,
+	.Latch = 0xFF
+};
+
+/* ##### Interrupts ##### */
+/**
+  * @brief 	Runs the completion callback of a background transfer whose STOP has passed,
+  * 		unless interrupts are masked or one is already running.
+  */
+static void HD44780_Sim_Deliver(void)
+{
+	while (Sim.Pending && (Sim.Counters.Time_ns >= Sim.Pending_End_ns) && (Sim.PriMask == 0U) && !Sim.In_Interrupt) {
+		I2C_HandleTypeDef *hi2c = Sim.Pending_Handle;
+
+		Sim.Pending = false;
+		Sim.In_Interrupt = true;
+		Sim.Counters.Interrupts++;
+		if (Sim.Pending_Failed) {
+			hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+			HAL_I2C_ErrorCallback(hi2c);
+		}
+
+		else {
+			HAL_I2C_MasterTxCpltCallback(hi2c);
+		}
+		Sim.In_Interrupt = false;
+	} /* The callback may start the next transfer */
+}
+
+/* ##### Bus ##### */
+/**
+  * @brief 	Bit time of the bus.
+  * @param 	Pointer to the I2C handle.
+  * @retval Nanoseconds per SCL period.
+  */
+static uint64_t HD44780_Sim_Bit_ns(const I2C_HandleTypeDef *hi2c)
+{
+	const uint32_t Clock_Hz = ((hi2c != NULL) && (hi2c->Init.ClockSpeed != 0U)) ? hi2c->Init.ClockSpeed : HD44780_SIM_I2C_HZ;
+
+	return (1000000000ULL / Clock_Hz);
+}
+
+/**
+  * @brief 	Plays one transaction against the device from the current time, without moving the clock.
+  * 		Written bytes reach the device at their ACK, received bytes are sampled at the previous ACK
+  * 		(PCF8574 pg. 10).
+  * @param 	Pointer to the I2C handle.
+  * @param 	8-bit address.
+  * @param 	Direction, HD44780_SIM_PROBE sends the address only.
+  * @param 	Port bytes to send or receive.
+  * @param 	Number of port bytes.
+  * @param 	Receives the time of STOP.
+  * @retval HAL_ERROR if the address was not acknowledged.
+  */
+static HAL_StatusTypeDef HD44780_Sim_Transfer(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, HD44780_Sim_Direction Direction, uint8_t *pData, uint16_t Size, uint64_t *End_ns)
+{
+	const uint64_t Bit_ns = HD44780_Sim_Bit_ns(hi2c);
+	HD44780_Sim_TransactionTypeDef *Record = &Sim.Log[Sim.Log_Count % HD44780_SIM_LOG_DEPTH];
+	uint64_t Time_ns = Sim.Counters.Time_ns + (10U * Bit_ns); /* START, address and ACK */
+	HAL_StatusTypeDef Status = HAL_OK;
+
+	memset(Record, 0, sizeof(*Record));
+	Record->Start_ns = Sim.Counters.Time_ns;
+	Record->Address = DevAddress;
+	Record->Direction = Direction;
+	Sim.Log_Count++;
+	Sim.Counters.Transactions++;
+
+	if (!Sim.Present) {
+		Sim.Counters.Nacks++;
+		hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+		Status = HAL_ERROR;
+	}
+
+	else {
+		hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+		for (uint16_t i = 0; (Direction != HD44780_SIM_PROBE) && (i < Size); i++) {
+			if (Direction == HD44780_SIM_WRITE) {
+				Time_ns += (9U * Bit_ns);
+				if (Sim.Has_Device) {
+					Sim.Device.Write(Sim.Device.Context, pData[i], Time_ns);
+				}
+
+				else {
+					Sim.Latch = pData[i];
+				}
+				Sim.Counters.Tx_Bytes++;
+			}
+
+			else {
+				if (Sim.Has_Device) {
+					pData[i] = Sim.Device.Read(Sim.Device.Context, Time_ns);
+				}
+
+				else {
+					const uint8_t Reading = HD44780_SIM_PORT_RW | HD44780_SIM_PORT_EN;
+					pData[i] = ((Sim.Latch & Reading) == Reading) ? (uint8_t)(Sim.Latch & 0x0F) : Sim.Latch;
+				} /* No model: data bits read LOW, never busy */
+				Time_ns += (9U * Bit_ns);
+				Sim.Counters.Rx_Bytes++;
+			}
+
+			if (i < HD44780_SIM_LOG_BYTES) {
+				Record->Bytes[i] = pData[i];
+			}
+			Record->Length++;
+		}
+	}
+	Time_ns += Bit_ns; /* STOP */
+
+	Record->End_ns = Time_ns;
+	Record->Status = Status;
+	*End_ns = Time_ns;
+
+	return Status;
+}
+
+/**
+  * @brief 	Blocking transfer, the clock moves to its STOP.
+  * @retval HAL_BUSY while a DMA/IT transfer is on the bus.
+  */
+static HAL_StatusTypeDef HD44780_Sim_Blocking(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, HD44780_Sim_Direction Direction, uint8_t *pData, uint16_t Size)
+{
+	uint64_t End_ns = 0;
+
+	if (Sim.Pending) {
+		return HAL_BUSY;
+	}
+
+	const HAL_StatusTypeDef Status = HD44780_Sim_Transfer(hi2c, DevAddress, Direction, pData, Size, &End_ns);
+	HD44780_Sim_Advance_ns(End_ns - Sim.Counters.Time_ns);
+
+	return Status;
+}
+
+/**
+  * @brief 	Background transfer, completes through HD44780_Sim_Deliver(). A NACK is reported by
+  * 		HAL_I2C_ErrorCallback() as on the target.
+  * @retval HAL_BUSY while another one is on the bus.
+  */
+static HAL_StatusTypeDef HD44780_Sim_Background(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size)
+{
+	if (Sim.Pending) {
+		return HAL_BUSY;
+	}
+
+	Sim.Pending_Failed = (HD44780_Sim_Transfer(hi2c, DevAddress, HD44780_SIM_WRITE, pData, Size, &Sim.Pending_End_ns) != HAL_OK);
+	Sim.Pending_Handle = hi2c;
+	Sim.Pending = true;
+
+	return HAL_OK;
+}
+
+/* ####################### Simulator Functions ############################### */
+/**
+  * @brief 	Back to time 0 with all counters and the log cleared, no device model and the
+  * 		address acknowledged.
+  */
+void HD44780_Sim_Reset(void)
+{
+	memset(&Sim, 0, sizeof(Sim));
+	Sim.Present = true;
+	Sim.Latch = 0xFF;
+}
+
+/**
+  * @brief 	Connects a device model to the bus, NULL disconnects it.
+  * @param 	Model callbacks, copied.
+  */
+void HD44780_Sim_Attach(const HD44780_Sim_DeviceTypeDef *Device)
+{
+	Sim.Has_Device = (Device != NULL);
+	if (Device != NULL) {
+		Sim.Device = *Device;
+	}
+}
+
+/**
+  * @brief 	Fault injection. False NACKs every following address byte, as an unplugged display.
+  * @param 	True if the device acknowledges.
+  */
+void HD44780_Sim_Set_Present(bool Present)
+{
+	Sim.Present = Present;
+}
+
+/**
+  * @brief 	Moves the simulated clock on and delivers the interrupts that became due.
+  * @param 	Nanoseconds.
+  */
+void HD44780_Sim_Advance_ns(uint64_t Nanoseconds)
+{
+	Sim.Counters.Time_ns += Nanoseconds;
+	HD44780_Sim_Deliver();
+}
+
+/**
+  * @brief 	Simulated time since HD44780_Sim_Reset().
+  * @retval Nanoseconds.
+  */
+uint64_t HD44780_Sim_Time_ns(void)
+{
+	return Sim.Counters.Time_ns;
+}
+
+/**
+  * @brief 	Copies the counters.
+  * @param 	Receives the counters.
+  */
+void HD44780_Sim_Snapshot(HD44780_Sim_CountersTypeDef *Counters)
+{
+	*Counters = Sim.Counters;
+}
+
+/**
+  * @brief 	Counters accumulated since a snapshot.
+  * @param 	Snapshot taken before the operation.
+  * @param 	Receives the difference.
+  */
+void HD44780_Sim_Since(const HD44780_Sim_CountersTypeDef *Start, HD44780_Sim_CountersTypeDef *Delta)
+{
+	Delta->Time_ns = Sim.Counters.Time_ns - Start->Time_ns;
+	Delta->Tx_Bytes = Sim.Counters.Tx_Bytes - Start->Tx_Bytes;
+	Delta->Rx_Bytes = Sim.Counters.Rx_Bytes - Start->Rx_Bytes;
+	Delta->Transactions = Sim.Counters.Transactions - Start->Transactions;
+	Delta->Nacks = Sim.Counters.Nacks - Start->Nacks;
+	Delta->Interrupts = Sim.Counters.Interrupts - Start->Interrupts;
+}
+
+/**
+  * @brief 	Number of transactions recorded since HD44780_Sim_Reset().
+  * @retval Next index HD44780_Sim_Log() will accept.
+  */
+uint32_t HD44780_Sim_Log_Count(void)
+{
+	return Sim.Log_Count;
+}
+
+/**
+  * @brief 	Looks up a recorded transaction.
+  * @param 	Index since HD44780_Sim_Reset(), 0 is the first one.
+  * @retval NULL if not recorded yet or already overwritten by the last HD44780_SIM_LOG_DEPTH.
+  */
+const HD44780_Sim_TransactionTypeDef *HD44780_Sim_Log(uint32_t Index)
+{
+	if ((Index >= Sim.Log_Count) || ((Sim.Log_Count - Index) > HD44780_SIM_LOG_DEPTH)) {
+		return NULL;
+	}
+
+	return &Sim.Log[Index % HD44780_SIM_LOG_DEPTH];
+}
+
+/* ####################### Core Registers ############################### */
+DWT_Type *HD44780_Sim_DWT(void)
+{
+	HD44780_Sim_Advance_ns(HD44780_SIM_CLOCK_READ_NS);
+	Sim.Dwt.CYCCNT = (uint32_t)((Sim.Counters.Time_ns * (HD44780_SIM_CORE_HZ / 1000000U)) / 1000U);
+
+	return &Sim.Dwt;
+}
+
+SysTick_Type *HD44780_Sim_SysTick(void)
+{
+	const uint32_t Reload = (HD44780_SIM_CORE_HZ / 1000U) - 1U;
+	const uint64_t Elapsed_ns = (Sim.Counters.Time_ns % HD44780_SIM_NS_PER_MS);
+
+	HD44780_Sim_Advance_ns(HD44780_SIM_CLOCK_READ_NS);
+	Sim.Systick.LOAD = Reload;
+	Sim.Systick.VAL = Reload - (uint32_t)((Elapsed_ns * (HD44780_SIM_CORE_HZ / 1000000U)) / 1000U); /* Counts down */
+
+	return &Sim.Systick;
+}
+
+uint32_t HD44780_Sim_TIM_Counter(TIM_HandleTypeDef *htim)
+{
+	(void)htim;
+	HD44780_Sim_Advance_ns(HD44780_SIM_CLOCK_READ_NS);
+
+	return (uint32_t)((Sim.Counters.Time_ns / 1000U) & 0xFFFFU); /* 16-bit TIM at 1MHz */
+}
+
+uint32_t __get_PRIMASK(void)
+{
+	return Sim.PriMask;
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+	Sim.PriMask = priMask;
+	HD44780_Sim_Deliver();
+}
+
+/**
+  * @brief 	Costs a clock read, so a loop that only enters critical sections while it waits for a
+  * 		transfer (a full transmit queue without HD44780_WAIT_SLEEP) still reaches its STOP.
+  */
+void __disable_irq(void)
+{
+	HD44780_Sim_Advance_ns(HD44780_SIM_CLOCK_READ_NS);
+	Sim.PriMask = 1U;
+}
+
+void __enable_irq(void)
+{
+	Sim.PriMask = 0U;
+	HD44780_Sim_Deliver();
+}
+
+/**
+  * @brief 	Sleeps until the next SysTick or the end of the background transfer. A pending
+  * 		interrupt wakes the core even while masked.
+  */
+void __WFI(void)
+{
+	uint64_t Wake_ns = ((Sim.Counters.Time_ns / HD44780_SIM_NS_PER_MS) + 1U) * HD44780_SIM_NS_PER_MS;
+
+	if (Sim.Pending && (Sim.Pending_End_ns < Wake_ns)) {
+		Wake_ns = (Sim.Pending_End_ns > Sim.Counters.Time_ns) ? Sim.Pending_End_ns : Sim.Counters.Time_ns;
+	}
+	HD44780_Sim_Advance_ns(Wake_ns - Sim.Counters.Time_ns);
+}
+
+void __DSB(void)
+{
+}
+
+/* ####################### HAL Functions ############################### */
+uint32_t HAL_GetTick(void)
+{
+	HD44780_Sim_Advance_ns(HD44780_SIM_CLOCK_READ_NS);
+
+	return (uint32_t)(Sim.Counters.Time_ns / HD44780_SIM_NS_PER_MS);
+}
+
+/**
+  * @brief 	As the HAL: at least Delay + 1 SysTick periods, ending on a tick.
+  */
+void HAL_Delay(uint32_t Delay)
+{
+	const uint64_t Start_ms = (Sim.Counters.Time_ns / HD44780_SIM_NS_PER_MS);
+	const uint64_t Wait_ms = (Delay < HAL_MAX_DELAY) ? ((uint64_t)Delay + 1U) : Delay;
+
+	HD44780_Sim_Advance_ns(((Start_ms + Wait_ms) * HD44780_SIM_NS_PER_MS) - Sim.Counters.Time_ns);
+}
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c)
+{
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c)
+{
+	(void)hi2c;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	(void)Timeout;
+
+	return HD44780_Sim_Blocking(hi2c, DevAddress, HD44780_SIM_WRITE, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	(void)Timeout;
+
+	return HD44780_Sim_Blocking(hi2c, DevAddress, HD44780_SIM_READ, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size)
+{
+	return HD44780_Sim_Background(hi2c, DevAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size)
+{
+	return HD44780_Sim_Background(hi2c, DevAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout)
+{
+	(void)Timeout;
+
+	for (uint32_t Trial = 0; Trial < Trials; Trial++) {
+		if (HD44780_Sim_Blocking(hi2c, DevAddress, HD44780_SIM_PROBE, NULL, 0) == HAL_OK) {
+			return HAL_OK;
+		}
+	}
+
+	return HAL_ERROR;
+}
+
+/* Defaults for builds without the driver's HAL callbacks (HD44780_USE_ASYNC 0) */
+__weak void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+	(void)hi2c;
+}
+
+__weak void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+	(void)hi2c;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim)
+{
+	(void)htim;
+
+	return HAL_OK;
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+	(void)GPIOx;
+	(void)GPIO_Init;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+	(void)GPIOx;
+	(void)GPIO_Pin;
+	(void)PinState;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	(void)GPIOx;
+	(void)GPIO_Pin;
+
+	return GPIO_PIN_SET; /* SDA released */
+}
+
+#if defined(HAL_SPI_MODULE_ENABLED)
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	(void)hspi;
+	(void)pData;
+	(void)Timeout;
+	HD44780_Sim_Advance_ns((uint64_t)Size * 1000U);
+
+	return HAL_OK;
+}
+#endif
@@ -0,0 +1,90 @@
+/*
+ * HD44780_Sim.h
+ *
+ *	Simulated clock and I2C bus behind the host stm32f1xx_hal.h. Every transaction the driver
+ *	starts is timed at the bus clock, counted and recorded, and its port bytes are passed to the
+ *	attached device model. Time only moves on bus transfers, delays and clock reads.
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+#ifndef HOST_HD44780_SIM_H_
+#define HOST_HD44780_SIM_H_
+
+/* ####################### INCLUDES ############################# */
+#include "stm32f1xx_hal.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ####################### USER DEFINES ############################### */
+#define HD44780_SIM_CORE_HZ         72000000 /* SystemCoreClock, DWT cycles and SysTick reload */
+#define HD44780_SIM_I2C_HZ          100000   /* Bus clock when hi2c->Init.ClockSpeed is 0 */
+#define HD44780_SIM_CLOCK_READ_NS   100      /* Spent by each clock read and __disable_irq(), keeps polling loops moving */
+#define HD44780_SIM_LOG_DEPTH       256      /* Transactions kept by the recorder */
+#define HD44780_SIM_LOG_BYTES       16       /* Port bytes kept per recorded transaction */
+
+/* ####################### DRIVER DEFINES ############################### */
+#define HAL_I2C_ERROR_NONE          0x00000000U
+#define HAL_I2C_ERROR_AF            0x00000004U /* Address not acknowledged */
+
+/* ####################### Structs ############################### */
+typedef enum {
+	HD44780_SIM_WRITE,
+	HD44780_SIM_READ,
+	HD44780_SIM_PROBE           /* HAL_I2C_IsDeviceReady(), address byte only */
+} HD44780_Sim_Direction;
+
+/* One recorded I2C transaction */
+typedef struct {
+	uint64_t                Start_ns;       /* START condition */
+	uint64_t                End_ns;         /* STOP condition */
+	uint16_t                Address;        /* 8-bit form, as passed to the HAL */
+	HD44780_Sim_Direction   Direction;
+	uint16_t                Length;         /* Port bytes */
+	HAL_StatusTypeDef       Status;
+	uint8_t                 Bytes[HD44780_SIM_LOG_BYTES]; /* First port bytes of the transaction */
+} HD44780_Sim_TransactionTypeDef;
+
+/* The I2C slave. Without one the port is a plain latch that reads back as ready */
+typedef struct {
+	void                    (*Write)(void *Context, uint8_t PortByte, uint64_t Time_ns); /* Port byte latched at its ACK */
+	uint8_t                 (*Read)(void *Context, uint64_t Time_ns);                    /* Port pins sampled for a receive */
+	void                    *Context;
+} HD44780_Sim_DeviceTypeDef;
+
+/* Subtract two snapshots for the cost of one operation */
+typedef struct {
+	uint64_t                Time_ns;
+	uint32_t                Tx_Bytes;       /* Port bytes written, address bytes not included */
+	uint32_t                Rx_Bytes;
+	uint32_t                Transactions;   /* Transmits, receives and probes */
+	uint32_t                Nacks;
+	uint32_t                Interrupts;     /* Transfer complete and error callbacks delivered */
+} HD44780_Sim_CountersTypeDef;
+
+
+/* ####################### Simulator Functions ############################### */
+void HD44780_Sim_Reset(void);
+void HD44780_Sim_Attach(const HD44780_Sim_DeviceTypeDef *Device);
+void HD44780_Sim_Set_Present(bool Present);
+void HD44780_Sim_Advance_ns(uint64_t Nanoseconds);
+uint64_t HD44780_Sim_Time_ns(void);
+void HD44780_Sim_Snapshot(HD44780_Sim_CountersTypeDef *Counters);
+void HD44780_Sim_Since(const HD44780_Sim_CountersTypeDef *Start, HD44780_Sim_CountersTypeDef *Delta);
+uint32_t HD44780_Sim_Log_Count(void);
+const HD44780_Sim_TransactionTypeDef *HD44780_Sim_Log(uint32_t Index);
+
+/* ####################### Kernel Functions (HD44780_Sim_RTOS.c) ############################### */
+void HD44780_Sim_RTOS_Reset(void);
+void HD44780_Sim_RTOS_Step(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_HD44780_SIM_H_ */
@@ -0,0 +1,249 @@
+/*
+ * HD44780_Sim_RTOS.c
+ *
+ *	Host implementation of the stub cmsis_os2.h on the simulated clock of HD44780_Sim.c. Like
+ *	osDelay() on a 1kHz kernel, a delay returns on the ticks'th SysTick, which is up to one tick
+ *	short of the time asked for. Queues are FIFOs and semaphores counters in static pools. Threads
+ *	don't run on their own: HD44780_Sim_RTOS_Step() runs each one until it waits on an empty queue.
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+#include "cmsis_os2.h"
+#include "HD44780_Sim.h"
+#include <setjmp.h>
+#include <string.h>
+
+/* ####################### DRIVER DEFINES ############################### */
+#define HD44780_SIM_RTOS_TICK_HZ    1000U
+#define HD44780_SIM_RTOS_TICK_NS    (1000000000ULL / HD44780_SIM_RTOS_TICK_HZ)
+#define HD44780_SIM_RTOS_OBJECTS    4U    /* Threads, queues and semaphores each */
+#define HD44780_SIM_RTOS_QUEUE_SIZE 1024U /* Message bytes per queue */
+
+/* ####################### Structs ############################### */
+typedef struct {
+	bool                    Used;
+	uint32_t                Depth;          /* Messages */
+	uint32_t                Size;           /* Bytes per message */
+	uint32_t                Head;           /* Oldest message */
+	uint32_t                Count;
+	uint8_t                 Storage[HD44780_SIM_RTOS_QUEUE_SIZE];
+} HD44780_Sim_RTOS_QueueTypeDef;
+
+typedef struct {
+	bool                    Used;
+	uint32_t                Max;
+	uint32_t                Count;
+} HD44780_Sim_RTOS_SemaphoreTypeDef;
+
+typedef struct {
+	osThreadFunc_t          Function;       /* NULL for a free slot */
+	void                    *Argument;
+} HD44780_Sim_RTOS_ThreadTypeDef;
+
+typedef struct {
+	HD44780_Sim_RTOS_QueueTypeDef Queues[HD44780_SIM_RTOS_OBJECTS];
+	HD44780_Sim_RTOS_SemaphoreTypeDef Semaphores[HD44780_SIM_RTOS_OBJECTS];
+	HD44780_Sim_RTOS_ThreadTypeDef Threads[HD44780_SIM_RTOS_OBJECTS];
+	bool                    In_Thread;      /* Inside HD44780_Sim_RTOS_Step(), a wait returns there */
+	jmp_buf                 Yield;
+} HD44780_Sim_RTOS_StateTypeDef;
+
+/* ####################### Variables ############################### */
+static HD44780_Sim_RTOS_StateTypeDef Kernel;
+
+/* ####################### Kernel Functions ############################### */
+/**
+  * @brief 	Deletes all threads, queues and semaphores.
+  */
+void HD44780_Sim_RTOS_Reset(void)
+{
+	memset(&Kernel, 0, sizeof(Kernel));
+}
+
+/**
+  * @brief 	Runs each thread from the top of its function until it waits on an empty queue. A task
+  * 		loop that only blocks there carries nothing over, so this continues it where it stopped.
+  * 		The idle timeout of that wait is not modelled, the caller decides when time moves on.
+  */
+void HD44780_Sim_RTOS_Step(void)
+{
+	for (uint32_t i = 0; i < HD44780_SIM_RTOS_OBJECTS; i++) {
+		const HD44780_Sim_RTOS_ThreadTypeDef *Thread = &Kernel.Threads[i];
+
+		if ((Thread->Function != NULL) && (setjmp(Kernel.Yield) == 0)) {
+			Kernel.In_Thread = true;
+			Thread->Function(Thread->Argument);
+		} /* A task never returns, its wait jumps back here */
+
+		Kernel.In_Thread = false;
+	}
+}
+
+/* ####################### Kernel ############################### */
+osKernelState_t osKernelGetState(void)
+{
+	return osKernelRunning;
+}
+
+osStatus_t osKernelStart(void)
+{
+	return osError;
+}
+
+uint32_t osKernelGetTickFreq(void)
+{
+	return HD44780_SIM_RTOS_TICK_HZ;
+}
+
+/**
+  * @brief 	Blocks until the ticks'th kernel tick from now, the calling task idles meanwhile.
+  */
+osStatus_t osDelay(uint32_t ticks)
+{
+	const uint64_t Now_ns = HD44780_Sim_Time_ns();
+	const uint64_t Wake_ns = ((Now_ns / HD44780_SIM_RTOS_TICK_NS) + ticks) * HD44780_SIM_RTOS_TICK_NS;
+
+	HD44780_Sim_Advance_ns(Wake_ns - Now_ns);
+
+	return osOK;
+}
+
+/* ####################### Threads ############################### */
+/**
+  * @brief 	Registers the thread for HD44780_Sim_RTOS_Step(), it does not run before that.
+  */
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr)
+{
+	(void)attr;
+
+	for (uint32_t i = 0; i < HD44780_SIM_RTOS_OBJECTS; i++) {
+		HD44780_Sim_RTOS_ThreadTypeDef *Thread = &Kernel.Threads[i];
+		if (Thread->Function == NULL) {
+			Thread->Function = func;
+			Thread->Argument = argument;
+			return Thread;
+		}
+	}
+
+	return NULL;
+}
+
+/* ####################### Message Queues ############################### */
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr)
+{
+	(void)attr;
+
+	if ((msg_count == 0U) || (msg_size == 0U) || (msg_count > (HD44780_SIM_RTOS_QUEUE_SIZE / msg_size))) {
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < HD44780_SIM_RTOS_OBJECTS; i++) {
+		HD44780_Sim_RTOS_QueueTypeDef *Queue = &Kernel.Queues[i];
+		if (!Queue->Used) {
+			memset(Queue, 0, sizeof(*Queue));
+			Queue->Used = true;
+			Queue->Depth = msg_count;
+			Queue->Size = msg_size;
+			return Queue;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+  * @brief 	Appends a message. A full queue fails at once, no other thread could make room.
+  */
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t msg_prio, uint32_t timeout)
+{
+	HD44780_Sim_RTOS_QueueTypeDef *Queue = (HD44780_Sim_RTOS_QueueTypeDef *)mq_id;
+	(void)msg_prio;
+
+	if (Queue->Count == Queue->Depth) {
+		return (timeout == 0U) ? osErrorResource : osErrorTimeout;
+	}
+
+	memcpy(&Queue->Storage[((Queue->Head + Queue->Count) % Queue->Depth) * Queue->Size], msg_ptr, Queue->Size);
+	Queue->Count++;
+
+	return osOK;
+}
+
+/**
+  * @brief 	Takes the oldest message. A thread waiting on an empty queue goes back to
+  * 		HD44780_Sim_RTOS_Step(), anyone else fails at once.
+  */
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, uint32_t timeout)
+{
+	HD44780_Sim_RTOS_QueueTypeDef *Queue = (HD44780_Sim_RTOS_QueueTypeDef *)mq_id;
+
+	if (Queue->Count == 0U) {
+		if ((timeout != 0U) && Kernel.In_Thread) {
+			longjmp(Kernel.Yield, 1);
+		}
+		return (timeout == 0U) ? osErrorResource : osErrorTimeout;
+	}
+
+	memcpy(msg_ptr, &Queue->Storage[Queue->Head * Queue->Size], Queue->Size);
+	Queue->Head = (Queue->Head + 1U) % Queue->Depth;
+	Queue->Count--;
+
+	if (msg_prio != NULL) {
+		*msg_prio = 0;
+	}
+
+	return osOK;
+}
+
+/* ####################### Semaphores ############################### */
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count, const osSemaphoreAttr_t *attr)
+{
+	(void)attr;
+
+	for (uint32_t i = 0; i < HD44780_SIM_RTOS_OBJECTS; i++) {
+		HD44780_Sim_RTOS_SemaphoreTypeDef *Semaphore = &Kernel.Semaphores[i];
+		if (!Semaphore->Used) {
+			Semaphore->Used = true;
+			Semaphore->Max = max_count;
+			Semaphore->Count = initial_count;
+			return Semaphore;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+  * @brief 	Takes a token. Without one it sleeps the timeout, interrupts may release it meanwhile.
+  */
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout)
+{
+	HD44780_Sim_RTOS_SemaphoreTypeDef *Semaphore = (HD44780_Sim_RTOS_SemaphoreTypeDef *)semaphore_id;
+
+	if ((Semaphore->Count == 0U) && (timeout != 0U)) {
+		osDelay(timeout);
+	}
+
+	if (Semaphore->Count == 0U) {
+		return (timeout == 0U) ? osErrorResource : osErrorTimeout;
+	}
+
+	Semaphore->Count--;
+
+	return osOK;
+}
+
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id)
+{
+	HD44780_Sim_RTOS_SemaphoreTypeDef *Semaphore = (HD44780_Sim_RTOS_SemaphoreTypeDef *)semaphore_id;
+
+	if (Semaphore->Count == Semaphore->Max) {
+		return osErrorResource;
+	}
+
+	Semaphore->Count++;
+
+	return osOK;
+}
@@ -0,0 +1,82 @@
+/*
+ * cmsis_os2.h
+ *
+ *	Host stand-in for the CMSIS-RTOS2 API, only what HD44780_RTOS.c uses. The kernel always reads
+ *	as running and osDelay() ends on a SysTick of the simulated clock, as a 1kHz kernel tick would.
+ *	Threads are created but only run inside HD44780_Sim_RTOS_Step(), see HD44780_Sim.h.
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+#ifndef HOST_CMSIS_OS2_H_
+#define HOST_CMSIS_OS2_H_
+
+/* ####################### INCLUDES ############################# */
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ####################### Structs ############################### */
+typedef enum {
+	osOK                    =  0,
+	osError                 = -1,
+	osErrorTimeout          = -2,
+	osErrorResource         = -3
+} osStatus_t;
+
+typedef enum {
+	osKernelInactive        =  0,
+	osKernelReady           =  1,
+	osKernelRunning         =  2
+} osKernelState_t;
+
+typedef enum {
+	osPriorityNormal        = 24,
+	osPriorityBelowNormal   = 16
+} osPriority_t;
+
+typedef void *osThreadId_t;
+typedef void *osMessageQueueId_t;
+typedef void *osSemaphoreId_t;
+typedef void (*osThreadFunc_t)(void *argument);
+
+typedef struct {
+	const char              *name;
+	uint32_t                stack_size;
+	osPriority_t            priority;
+} osThreadAttr_t;
+
+typedef struct {
+	const char              *name;
+} osMessageQueueAttr_t;
+
+typedef struct {
+	const char              *name;
+} osSemaphoreAttr_t;
+
+/* ####################### RTOS Functions ############################### */
+osKernelState_t osKernelGetState(void);
+osStatus_t osKernelStart(void);
+uint32_t osKernelGetTickFreq(void);
+osStatus_t osDelay(uint32_t ticks);
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr);
+
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr);
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t msg_prio, uint32_t timeout);
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, uint32_t timeout);
+
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count, const osSemaphoreAttr_t *attr);
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout);
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_CMSIS_OS2_H_ */
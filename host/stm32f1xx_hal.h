@@ -0,0 +1,149 @@
+/*
+ * stm32f1xx_hal.h
+ *
+ *	Host stand-in for the STM32F1 HAL, only what the HD44780 driver uses. The functions are
+ *	implemented by HD44780_Sim.c on a simulated clock, so the driver builds and runs on a PC.
+ *	Not for the target, the real HAL header has the same name.
+ *
+ *  Created on: Jan 6, 2022
+ *  Author: Ian Ress
+ */
+
+#ifndef HOST_STM32F1XX_HAL_H_
+#define HOST_STM32F1XX_HAL_H_
+
+/* ####################### INCLUDES ############################# */
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ####################### DRIVER DEFINES ############################### */
+#define __weak                      __attribute__((weak))
+#define HAL_MAX_DELAY               0xFFFFFFFFU
+
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+
+#define GPIO_MODE_INPUT             0x00000000U
+#define GPIO_MODE_OUTPUT_PP         0x00000001U
+#define GPIO_MODE_OUTPUT_OD         0x00000011U
+#define GPIO_NOPULL                 0x00000000U
+#define GPIO_PULLUP                 0x00000001U
+#define GPIO_SPEED_FREQ_LOW         0x00000002U
+#define GPIO_SPEED_FREQ_HIGH        0x00000003U
+
+/* Core registers read through the simulator, every read moves the simulated clock on */
+#define DWT                         (HD44780_Sim_DWT())
+#define SysTick                     (HD44780_Sim_SysTick())
+#define CoreDebug                   (&HD44780_Sim_CoreDebug)
+#define __HAL_TIM_GET_COUNTER(h)    (HD44780_Sim_TIM_Counter(h))
+#define __HAL_TIM_SET_COUNTER(h, v) ((void)(h), (void)(v))
+
+/* ####################### Structs ############################### */
+typedef enum {
+	HAL_OK       = 0x00U,
+	HAL_ERROR    = 0x01U,
+	HAL_BUSY     = 0x02U,
+	HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum {
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct {
+	uint32_t                ClockSpeed;     /* SCL Hz, 0 = 100kHz */
+} I2C_InitTypeDef;
+
+typedef struct {
+	void                    *Instance;
+	I2C_InitTypeDef         Init;
+	volatile uint32_t       ErrorCode;
+} I2C_HandleTypeDef;
+
+typedef struct {
+	void                    *Instance;
+} TIM_HandleTypeDef;
+
+typedef struct {
+	volatile uint32_t       CRL, CRH, IDR, ODR, BSRR, BRR, LCKR;
+} GPIO_TypeDef;
+
+typedef struct {
+	uint32_t                Pin;
+	uint32_t                Mode;
+	uint32_t                Pull;
+	uint32_t                Speed;
+} GPIO_InitTypeDef;
+
+typedef struct {
+	volatile uint32_t       CTRL;
+	volatile uint32_t       CYCCNT;
+} DWT_Type;
+
+typedef struct {
+	volatile uint32_t       DEMCR;
+} CoreDebug_Type;
+
+typedef struct {
+	volatile uint32_t       CTRL;
+	volatile uint32_t       LOAD;
+	volatile uint32_t       VAL;
+	volatile uint32_t       CALIB;
+} SysTick_Type;
+
+#if defined(HAL_SPI_MODULE_ENABLED)
+typedef struct {
+	void                    *Instance;
+} SPI_HandleTypeDef;
+#endif
+
+/* ####################### HAL Functions ############################### */
+extern uint32_t SystemCoreClock;
+extern CoreDebug_Type HD44780_Sim_CoreDebug;
+
+DWT_Type *HD44780_Sim_DWT(void);
+SysTick_Type *HD44780_Sim_SysTick(void);
+uint32_t HD44780_Sim_TIM_Counter(TIM_HandleTypeDef *htim);
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials, uint32_t Timeout);
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim);
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+#if defined(HAL_SPI_MODULE_ENABLED)
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+#endif
+
+/* CMSIS core intrinsics */
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+void __disable_irq(void);
+void __enable_irq(void);
+void __WFI(void);
+void __DSB(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_STM32F1XX_HAL_H_ */